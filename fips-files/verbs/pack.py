@@ -0,0 +1,104 @@
+'''
+Pack ROM images and program files into a single archive
+'''
+
+import os
+import sys
+import glob
+import zlib
+import struct
+
+from mod import log, util
+
+# table of contents entry: name, type, compat, offset, packed_size, size, crc32
+TOC_ENTRY = struct.Struct('<32s12sIIIII')
+HEADER = struct.Struct('<4sIII')
+VERSION = 1
+
+# system bitmasks (see enum class system in yakc/util/core.h)
+ANY = 0x7FFFFFFF
+ANY_KC85 = (1<<0)|(1<<1)|(1<<2)
+ANY_Z9001 = (1<<7)|(1<<8)
+ANY_CPC = (1<<11)|(1<<12)|(1<<13)
+CPC6128 = (1<<12)
+ACORN_ATOM = (1<<15)
+ANY_C64 = (1<<16)|(1<<17)
+
+#-------------------------------------------------------------------------------
+def file_meta(name) :
+    """guess filetype and compatible systems from the file name, ambiguous
+    formats get the filetype 'none' which lets the loader decide
+    """
+    lname = name.lower()
+    ext = os.path.splitext(lname)[1]
+    if ext in ['.kcc', '.853'] and not lname.startswith('caos') and not lname.startswith('basic') :
+        return 'kcc', ANY_KC85 if lname != 'zm30.kcc' else ANY_Z9001
+    elif ext == '.sna' :
+        return 'cpc_sna', ANY_CPC
+    elif ext == '.dsk' :
+        return 'cpc_dsk', CPC6128
+    elif ext == '.txt' :
+        return 'text', ANY
+    elif lname.startswith('cpcacid_') :
+        return 'cpc_bin', ANY_CPC
+    elif lname.endswith('_c64.tap') :
+        return 'c64_tap', ANY_C64
+    elif ext in ['.tap', '.z80'] :
+        return 'none', ANY
+    else :
+        # ROM images and other raw data
+        return 'raw', ANY
+
+#-------------------------------------------------------------------------------
+def pack(src_dir, dst_path) :
+    names = []
+    for path in sorted(glob.glob(src_dir + '/*')) :
+        name = os.path.basename(path)
+        if not os.path.isfile(path) :
+            continue
+        if len(name) >= 32 :
+            log.warn("skipping '{}', file name too long".format(name))
+            continue
+        names.append(name)
+    entries = []
+    blobs = []
+    offset = HEADER.size + len(names) * TOC_ENTRY.size
+    for name in names :
+        with open(src_dir + '/' + name, 'rb') as f :
+            data = f.read()
+        packed = zlib.compress(data, 9)
+        if len(packed) >= len(data) :
+            # store uncompressed
+            packed = data
+        ftype, compat = file_meta(name)
+        entries.append(TOC_ENTRY.pack(name.encode('ascii'), ftype.encode('ascii'), compat,
+            offset, len(packed), len(data), zlib.crc32(data) & 0xFFFFFFFF))
+        blobs.append(packed)
+        offset += len(packed)
+    with open(dst_path, 'wb') as f :
+        f.write(HEADER.pack(b'YPAK', VERSION, len(entries), 0))
+        for e in entries :
+            f.write(e)
+        for b in blobs :
+            f.write(b)
+    log.colored(log.GREEN, "packed {} files into '{}' ({} bytes)".format(len(entries), dst_path, offset))
+
+#-------------------------------------------------------------------------------
+def run(fips_dir, proj_dir, args) :
+    src_dir = args[0] if len(args) > 0 else proj_dir + '/files'
+    if len(args) > 1 :
+        dst_path = args[1]
+    else :
+        ws_dir = util.get_workspace_dir(fips_dir)
+        dst_dir = '{}/fips-deploy/yakc'.format(ws_dir)
+        if not os.path.isdir(dst_dir) :
+            os.makedirs(dst_dir)
+        dst_path = dst_dir + '/yakc.pak'
+    pack(src_dir, dst_path)
+
+#-------------------------------------------------------------------------------
+def help() :
+    log.info(log.YELLOW +
+             'fips pack [src_dir] [dst_file]\n' +
+             log.DEF +
+             '    pack ROM images and program files into yakc.pak')
@@ -11,6 +11,11 @@ from distutils.dir_util import copy_tree
 
 from mod import log, util, project, emscripten, android, nacl
 
+# the pack verb lives next to this file
+import sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import pack
+
 #-------------------------------------------------------------------------------
 def deploy_webpage(fips_dir, proj_dir, webpage_dir) :
     """builds the final webpage under under fips-deploy/oryol-webpage"""
@@ -31,6 +36,9 @@ def deploy_webpage(fips_dir, proj_dir, webpage_dir) :
         if os.path.isfile(fname):
             shutil.copy(fname, webpage_dir + '/' + os.path.basename(fname))
 
+    # ...and the packed archive, loose files are the fallback
+    pack.pack(proj_dir + '/files', webpage_dir + '/yakc.pak')
+
     # if the virtualkc directory exists, copy everything there
     # so that a simple git push is enough to upload
     # the webpage
@@ -13,19 +13,6 @@ YAKC::atom_t YAKC::atom;
 
 namespace YAKC {
 
-//------------------------------------------------------------------------------
-bool
-atom_t::check_roms(system model) {
-    if (system::acorn_atom == model) {
-        return roms.has(rom_images::atom_basic) &&
-               roms.has(rom_images::atom_float) &&
-               roms.has(rom_images::atom_dos);
-    }
-    else {
-        return false;
-    }
-}
-
 //------------------------------------------------------------------------------
 void
 atom_t::poweron() {
@@ -35,8 +22,9 @@ atom_t::poweron() {
     atom_desc_t desc = {};
     desc.audio_cb = atom_t::audio_cb;
     desc.audio_sample_rate = board.audio_sample_rate;
+    board.select_rgba8_buffer(MC6847_DISPLAY_WIDTH, MC6847_DISPLAY_HEIGHT);
     desc.pixel_buffer = board.rgba8_buffer;
-    desc.pixel_buffer_size = sizeof(board.rgba8_buffer);
+    desc.pixel_buffer_size = board.rgba8_buffer_size;
     desc.rom_abasic = roms.ptr(rom_images::atom_basic);
     desc.rom_abasic_size = roms.size(rom_images::atom_basic);
     desc.rom_afloat = roms.ptr(rom_images::atom_float);
@@ -52,6 +40,8 @@ atom_t::poweron() {
     board.beeper_1 = &sys.beeper;
     board.kbd = &sys.kbd;
     board.mem = &sys.mem;
+    board.sys_state = &sys;
+    board.sys_state_size = sizeof(sys);
 }
 
 //------------------------------------------------------------------------------
@@ -74,6 +64,7 @@ atom_t::reset() {
 void
 atom_t::exec(uint32_t micro_seconds) {
     YAKC_ASSERT(on);
+    YAKC_PROFILE_SCOPE(system);
     atom_exec(&sys, micro_seconds);
 }
 
@@ -130,11 +121,28 @@ atom_t::framebuffer(int& out_width, int& out_height) {
 //------------------------------------------------------------------------------
 void
 atom_t::audio_cb(const float* samples, int num_samples, void* /*user_data*/) {
+    if (board.mute_audio) {
+        return;
+    }
+    YAKC_PROFILE_SCOPE(audio);
     for (int i = 0; i < num_samples; i++) {
         board.audiobuffer.write(samples[i]);
     }
 }
 
+//------------------------------------------------------------------------------
+void
+atom_t::decode_io(uint64_t pins, bool write, iostats& stats) {
+    // memory-mapped PPI at 0xB000..0xB3FF, VIA at 0xB800..0xBBFF
+    const uint16_t addr = M6502_GET_ADDR(pins);
+    if ((addr & 0xFC00) == 0xB000) {
+        stats.add(chip::i8255, addr & 3, write);
+    }
+    else if ((addr & 0xFC00) == 0xB800) {
+        stats.add(chip::m6522, addr & 0x0F, write);
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 atom_t::decode_audio(float* buffer, int num_samples) {
@@ -147,11 +155,12 @@ atom_t::quickload(filesystem* fs, const char* name, filetype type, bool start) {
     YAKC_ASSERT(on);
     bool success = false;
     int num_bytes = 0;
-    const uint8_t* ptr = (const uint8_t*) fs->get(name, num_bytes);
+    const filesystem::file fp = fs->find(name);
+    const uint8_t* ptr = (const uint8_t*) fs->get(fp, num_bytes);
     if (ptr && (num_bytes > 0)) {
         success = atom_insert_tape(&sys, ptr, num_bytes);
     }
-    fs->rm(name);
+    fs->rm(fp);
     return success;
 }
 
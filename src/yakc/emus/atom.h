@@ -7,6 +7,7 @@
     https://fjkraan.home.xs4all.nl/comp/atom/index.html
 */
 #include "yakc/util/breadboard.h"
+#include "yakc/util/iostats.h"
 #include "yakc/util/rom_images.h"
 #include "yakc/util/filesystem.h"
 #include "yakc/util/filetypes.h"
@@ -16,9 +17,6 @@ namespace YAKC {
 
 class atom_t {
 public:
-    /// check if required roms are loaded
-    static bool check_roms(system model);
-
     /// power-on the device
     void poweron();
     /// power-off the device
@@ -48,6 +46,8 @@ public:
     bool quickload(filesystem* fs, const char* name, filetype type, bool start);
     /// audio callback 
     static void audio_cb(const float* samples, int num_samples, void* user_data);
+    /// count I/O accesses per chip register (iostats decoder)
+    static void decode_io(uint64_t pins, bool write, iostats& stats);
 
     ::atom_t sys;
     bool on = false;
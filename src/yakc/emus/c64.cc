@@ -5,6 +5,15 @@
 //  - need a way to route joystick input either to joystick 1 or 2, 
 //    in Zaxxon the jet color flashes on input from joystick 1 (probably
 //    to tell the player that joystick 2 controls the jet)
+//
+//  Fast tape loading:
+//  TAP files contain the raw tape pulses, and are normally played back
+//  in real time. With fast_tape enabled, the blocks written by the
+//  standard ROM loader are decoded when the tape is inserted, and the
+//  KERNAL LOAD routine is trapped to copy them directly into memory.
+//  The rest of the tape is then handed to the real-time playback for
+//  programs which use a custom loader after the first file.
+//  Tape encoding: http://c64tapes.org/dokuwiki/doku.php?id=loaders:rom_loader
 //------------------------------------------------------------------------------
 #include "c64.h"
 
@@ -12,19 +21,6 @@ YAKC::c64_t YAKC::c64;
 
 namespace YAKC {
 
-//------------------------------------------------------------------------------
-bool
-c64_t::check_roms(system model) {
-    if (system::c64_pal == model) {
-        return roms.has(rom_images::c64_basic) &&
-               roms.has(rom_images::c64_char) &&
-               roms.has(rom_images::c64_kernalv3);
-    }
-    else {
-        return false;
-    }
-}
-
 //------------------------------------------------------------------------------
 void
 c64_t::poweron(system m) {
@@ -34,8 +30,10 @@ c64_t::poweron(system m) {
     this->on = true;
 
     c64_desc_t desc = {};
+    // the VIC debug visualization renders the whole video frame
+    board.select_rgba8_buffer(global_max_fb_width, global_max_fb_height);
     desc.pixel_buffer = board.rgba8_buffer;
-    desc.pixel_buffer_size = sizeof(board.rgba8_buffer);
+    desc.pixel_buffer_size = board.rgba8_buffer_size;
     desc.audio_cb = c64_t::audio_cb;
     desc.audio_sample_rate = board.audio_sample_rate;
     desc.audio_tape_sound = true;
@@ -54,12 +52,15 @@ c64_t::poweron(system m) {
     board.m6581 = &sys.sid;
     board.kbd = &sys.kbd;
     board.mem = &sys.mem_cpu;
+    board.sys_state = &sys;
+    board.sys_state_size = sizeof(sys);
 }
 
 //------------------------------------------------------------------------------
 void
 c64_t::poweroff() {
     YAKC_ASSERT(on);
+    this->eject_tape();
     on = false;
     c64_discard(&sys);
     board.clear();
@@ -76,7 +77,14 @@ c64_t::reset() {
 void
 c64_t::exec(uint32_t micro_seconds) {
     YAKC_ASSERT(on);
+    YAKC_PROFILE_SCOPE(system);
     c64_exec(&sys, micro_seconds);
+    if (sys.cpu.trap_id == load_trap_id) {
+        if (!this->trap_load()) {
+            // not a standard ROM loader file, continue in real time
+            this->eject_tape();
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -131,14 +139,103 @@ c64_t::framebuffer(int& out_width, int &out_height) {
     return board.rgba8_buffer;
 }
 
+//------------------------------------------------------------------------------
+paste_result
+c64_t::paste_char(uint8_t ascii) {
+    YAKC_ASSERT(on);
+    // convert to PETSCII the same way as the keyboard matrix mapping,
+    // upper case letters are unshifted keys, lower case letters shifted
+    uint8_t petscii = 0;
+    if ((ascii >= 'a') && (ascii <= 'z')) {
+        petscii = ascii + 0x60;
+    }
+    else if (((ascii >= 0x20) && (ascii <= 'Z')) || (ascii == '[') || (ascii == ']') || (ascii == 0x0D)) {
+        petscii = ascii;
+    }
+    else {
+        return paste_result::unsupported;
+    }
+    // the KERNAL keyboard buffer is at $0277, the number of characters
+    // in the buffer at $C6 and the max buffer size at $0289
+    mem_t* mem = &sys.mem_cpu;
+    const uint8_t num = mem_rd(mem, 0xC6);
+    uint8_t max_num = mem_rd(mem, 0x0289);
+    if (max_num > 10) {
+        max_num = 10;
+    }
+    if (num >= max_num) {
+        return paste_result::busy;
+    }
+    mem_wr(mem, 0x0277 + num, petscii);
+    mem_wr(mem, 0xC6, num + 1);
+    return paste_result::ok;
+}
+
+//------------------------------------------------------------------------------
+void
+c64_t::advance_timers(uint32_t micro_seconds) {
+    YAKC_ASSERT(on);
+    // the jiffy clock at $A0..$A2 (big endian) counts at 60 Hz,
+    // and wraps around after 24 hours
+    this->timer_us += micro_seconds;
+    const uint32_t jiffies = uint32_t((uint64_t(this->timer_us) * 60) / 1000000);
+    if (jiffies > 0) {
+        this->timer_us -= uint32_t((uint64_t(jiffies) * 1000000) / 60);
+        mem_t* mem = &sys.mem_cpu;
+        uint32_t val = (mem_rd(mem, timer_addr)<<16) | (mem_rd(mem, timer_addr+1)<<8) | mem_rd(mem, timer_addr+2);
+        val = (val + jiffies) % 0x4F1A01;
+        mem_wr(mem, timer_addr, val>>16);
+        mem_wr(mem, timer_addr+1, val>>8);
+        mem_wr(mem, timer_addr+2, val);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+c64_t::tape_motor_on() const {
+    // the datasette motor line
+    return 0 != (sys.cas_port & C64_CASPORT_MOTOR);
+}
+
 //------------------------------------------------------------------------------
 void
 c64_t::audio_cb(const float* samples, int num_samples, void* /*user_data*/) {
+    if (board.mute_audio) {
+        return;
+    }
+    YAKC_PROFILE_SCOPE(audio);
     for (int i = 0; i < num_samples; i++) {
         board.audiobuffer.write(samples[i]);
     }
 }
 
+//------------------------------------------------------------------------------
+void
+c64_t::decode_io(uint64_t pins, bool write, iostats& stats) {
+    // VIC-II at 0xD000, SID at 0xD400, CIA-1 at 0xDC00, CIA-2 at 0xDD00,
+    // only while the I/O area is mapped in
+    const uint16_t addr = M6502_GET_ADDR(pins);
+    if (((addr & 0xF000) != 0xD000) || !c64.sys.io_mapped) {
+        return;
+    }
+    switch (addr & 0x0F00) {
+        case 0x0000: case 0x0100: case 0x0200: case 0x0300:
+            stats.add(chip::m6569, addr & 0x3F, write);
+            break;
+        case 0x0400: case 0x0500: case 0x0600: case 0x0700:
+            stats.add(chip::m6581, addr & 0x1F, write);
+            break;
+        case 0x0C00:
+            stats.add(chip::m6526, addr & 0x0F, write);
+            break;
+        case 0x0D00:
+            stats.add(chip::m6526_2, addr & 0x0F, write);
+            break;
+        default:
+            break;
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 c64_t::decode_audio(float* buffer, int num_samples) {
@@ -151,20 +248,296 @@ c64_t::quickload(filesystem* fs, const char* name, filetype type, bool start) {
     YAKC_ASSERT(on);
     bool success = false;
     int num_bytes = 0;
-    const uint8_t* ptr = (const uint8_t*) fs->get(name, num_bytes);
+    const filesystem::file fp = fs->find(name);
+    const uint8_t* ptr = (const uint8_t*) fs->get(fp, num_bytes);
     if (ptr && (num_bytes > 0)) {
         if (type == filetype::c64_tap) {
             success = c64_insert_tape(&sys, ptr, num_bytes);
             c64_start_tape(&sys);
+            if (success && this->fast_tape) {
+                this->decode_tape(ptr, num_bytes);
+            }
         }
         else {
             success = c64_quickload(&sys, ptr, num_bytes);
         }
     }
-    fs->rm(name);
+    fs->rm(fp);
     return success;
 }
 
+//------------------------------------------------------------------------------
+namespace {
+
+enum pulse_kind {
+    pulse_invalid,
+    pulse_short,
+    pulse_medium,
+    pulse_long,
+};
+
+// read the next pulse from TAP data, and classify it by length
+pulse_kind read_pulse(const uint8_t* ptr, int end, int version, int& pos) {
+    if (pos >= end) {
+        return pulse_invalid;
+    }
+    int val = ptr[pos++];
+    if (0 == val) {
+        // a pause, version 1 has a 24-bit cycle count
+        if (version > 0) {
+            pos += 3;
+        }
+        return pulse_invalid;
+    }
+    if (val < 0x20) {
+        return pulse_invalid;
+    }
+    else if (val < 0x3B) {
+        return pulse_short;
+    }
+    else if (val < 0x4E) {
+        return pulse_medium;
+    }
+    else if (val < 0x70) {
+        return pulse_long;
+    }
+    else {
+        return pulse_invalid;
+    }
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void
+c64_t::decode_tape(const uint8_t* ptr, int num_bytes) {
+    this->eject_tape();
+    if (num_bytes <= int(sizeof(c64tap_header))) {
+        return;
+    }
+    const c64tap_header* hdr = (const c64tap_header*) ptr;
+    if (0 != memcmp(hdr->signature, "C64-TAPE-RAW", sizeof(hdr->signature))) {
+        return;
+    }
+    this->tape_size = num_bytes;
+    this->tape_pulses = (uint8_t*) YAKC_MALLOC(num_bytes);
+    memcpy(this->tape_pulses, ptr, num_bytes);
+    // each byte needs at least 20 pulses
+    this->tape_bytes = (uint8_t*) YAKC_MALLOC(num_bytes / 20 + 1);
+
+    // decode runs of bytes, a run is terminated by an end-of-data marker
+    // or anything which isn't a valid byte
+    const int version = hdr->version;
+    const int end = num_bytes;
+    int pos = sizeof(c64tap_header);
+    int num_decoded = 0;
+    int run_start = 0;
+    auto finish_run = [this, &num_decoded, &run_start, &pos]() {
+        const uint8_t* run = this->tape_bytes + run_start;
+        const int len = num_decoded - run_start;
+        // a ROM loader block starts with a countdown $89..$81 (or $09..$01
+        // for the repeated copy), and ends with an XOR checksum
+        if ((len > 10) && (this->num_tape_blocks < max_tape_blocks)) {
+            const bool first = (0x89 == run[0]);
+            bool valid = first || (0x09 == run[0]);
+            for (int i = 1; valid && (i < 9); i++) {
+                valid = (run[i] == (run[0] - i));
+            }
+            uint8_t chksum = 0;
+            for (int i = 9; i < (len - 1); i++) {
+                chksum ^= run[i];
+            }
+            if (valid && (chksum == run[len-1])) {
+                tape_block& blk = this->tape_blocks[this->num_tape_blocks++];
+                blk.first_copy = first;
+                blk.data_pos = run_start + 9;
+                blk.size = len - 10;
+                blk.pulse_end = pos;
+            }
+        }
+        run_start = num_decoded;
+    };
+    while (pos < end) {
+        const pulse_kind k0 = read_pulse(ptr, end, version, pos);
+        if (pulse_long != k0) {
+            if (num_decoded > run_start) {
+                finish_run();
+            }
+            continue;
+        }
+        const int marker_pos = pos;
+        const pulse_kind k1 = read_pulse(ptr, end, version, pos);
+        if (pulse_short == k1) {
+            // end-of-data marker
+            finish_run();
+            continue;
+        }
+        else if (pulse_medium != k1) {
+            finish_run();
+            pos = marker_pos;
+            continue;
+        }
+        // new-data marker, followed by 8 data bits (LSB first) and an odd parity bit
+        uint8_t byte = 0;
+        uint8_t parity = 1;
+        bool valid = true;
+        for (int bit = 0; valid && (bit < 9); bit++) {
+            const pulse_kind b0 = read_pulse(ptr, end, version, pos);
+            const pulse_kind b1 = read_pulse(ptr, end, version, pos);
+            uint8_t val = 0;
+            if ((pulse_short == b0) && (pulse_medium == b1)) {
+                val = 0;
+            }
+            else if ((pulse_medium == b0) && (pulse_short == b1)) {
+                val = 1;
+            }
+            else {
+                valid = false;
+            }
+            if (bit < 8) {
+                byte |= val<<bit;
+                parity ^= val;
+            }
+            else {
+                valid &= (val == parity);
+            }
+        }
+        if (valid) {
+            this->tape_bytes[num_decoded++] = byte;
+        }
+        else {
+            finish_run();
+        }
+    }
+    finish_run();
+
+    if (this->num_tape_blocks > 0) {
+        m6502_set_trap(&sys.cpu, load_trap_id, load_addr);
+    }
+    else {
+        this->eject_tape();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+c64_t::eject_tape() {
+    if (this->tape_pulses) {
+        YAKC_FREE(this->tape_pulses);
+        this->tape_pulses = nullptr;
+    }
+    if (this->tape_bytes) {
+        YAKC_FREE(this->tape_bytes);
+        this->tape_bytes = nullptr;
+    }
+    this->tape_size = 0;
+    this->num_tape_blocks = 0;
+    this->cur_tape_block = 0;
+    if (this->on) {
+        m6502_clear_trap(&sys.cpu, load_trap_id);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+c64_t::play_rest_of_tape(int pulse_pos) {
+    YAKC_ASSERT(this->tape_pulses && (pulse_pos <= this->tape_size));
+    const int rest = this->tape_size - pulse_pos;
+    if (rest <= 0) {
+        return;
+    }
+    const int size = sizeof(c64tap_header) + rest;
+    uint8_t* buf = (uint8_t*) YAKC_MALLOC(size);
+    memcpy(buf, this->tape_pulses, sizeof(c64tap_header));
+    ((c64tap_header*)buf)->size = rest;
+    memcpy(buf + sizeof(c64tap_header), this->tape_pulses + pulse_pos, rest);
+    c64_insert_tape(&sys, buf, size);
+    c64_start_tape(&sys);
+    YAKC_FREE(buf);
+}
+
+//------------------------------------------------------------------------------
+bool
+c64_t::trap_load() {
+    mem_t* mem = &sys.mem_cpu;
+    // only handle LOAD (not VERIFY) from the tape device
+    if ((0 != sys.cpu.state.A) || (1 != mem_rd(mem, 0xBA)) || !this->tape_bytes) {
+        return false;
+    }
+    const uint8_t sec_addr = mem_rd(mem, 0xB9);
+    const int name_len = mem_rd(mem, 0xB7);
+    const uint16_t name_addr = mem_rd(mem, 0xBB) | (mem_rd(mem, 0xBC)<<8);
+
+    // find the next matching header block, and its data block
+    int hdr_index = -1;
+    int data_index = -1;
+    for (int i = this->cur_tape_block; (i < this->num_tape_blocks) && (data_index < 0); i++) {
+        const tape_block& blk = this->tape_blocks[i];
+        const uint8_t* hdr = this->tape_bytes + blk.data_pos;
+        if ((blk.size != 192) || ((hdr[0] != 1) && (hdr[0] != 3))) {
+            continue;
+        }
+        bool match = true;
+        for (int c = 0; match && (c < name_len) && (c < 16); c++) {
+            const uint8_t chr = mem_rd(mem, name_addr + c);
+            if ('*' == chr) {
+                break;
+            }
+            match = ('?' == chr) || (chr == hdr[5 + c]);
+        }
+        if (!match) {
+            continue;
+        }
+        const int len = ((hdr[3] | hdr[4]<<8) - (hdr[1] | hdr[2]<<8)) & 0xFFFF;
+        for (int j = i + 1; j < this->num_tape_blocks; j++) {
+            const tape_block& data = this->tape_blocks[j];
+            if ((data.size == len) && !((data.size == 192) && (0 == memcmp(hdr, this->tape_bytes + data.data_pos, 192)))) {
+                hdr_index = i;
+                data_index = j;
+                break;
+            }
+        }
+    }
+    if (data_index < 0) {
+        return false;
+    }
+
+    // copy the data block into memory
+    const uint8_t* hdr = this->tape_bytes + this->tape_blocks[hdr_index].data_pos;
+    const tape_block& data = this->tape_blocks[data_index];
+    uint16_t addr = hdr[1] | hdr[2]<<8;
+    if ((1 == hdr[0]) && (0 == sec_addr)) {
+        // relocatable program, load to address passed to LOAD
+        addr = mem_rd(mem, 0xC3) | (mem_rd(mem, 0xC4)<<8);
+    }
+    for (int i = 0; i < data.size; i++) {
+        mem_wr(mem, addr++, this->tape_bytes[data.data_pos + i]);
+    }
+
+    // skip the repeated copy of the data block
+    int next = data_index + 1;
+    if ((next < this->num_tape_blocks) && (this->tape_blocks[next].size == data.size) && !this->tape_blocks[next].first_copy) {
+        next++;
+    }
+    this->cur_tape_block = next;
+    this->play_rest_of_tape(this->tape_blocks[next - 1].pulse_end);
+
+    // return from LOAD with success: end address in X/Y and $AE/$AF,
+    // status byte cleared and carry flag cleared
+    mem_wr(mem, 0xAE, addr & 0xFF);
+    mem_wr(mem, 0xAF, addr >> 8);
+    mem_wr(mem, 0x90, 0x00);
+    m6502_state_t& cpu = sys.cpu.state;
+    cpu.X = addr & 0xFF;
+    cpu.Y = addr >> 8;
+    cpu.P &= ~M6502_CF;
+    const uint8_t ret_l = mem_rd(mem, 0x0100 | ((cpu.S + 1) & 0xFF));
+    const uint8_t ret_h = mem_rd(mem, 0x0100 | ((cpu.S + 2) & 0xFF));
+    cpu.S += 2;
+    cpu.PC = ((ret_h<<8) | ret_l) + 1;
+    return true;
+}
+
 //------------------------------------------------------------------------------
 const char*
 c64_t::system_info() const {
@@ -5,8 +5,10 @@
     @brief Commodore C64 emulation
 */
 #include "yakc/util/breadboard.h"
+#include "yakc/util/iostats.h"
 #include "yakc/util/rom_images.h"
 #include "yakc/util/filetypes.h"
+#include "yakc/util/paste.h"
 #include "yakc/util/filesystem.h"
 #include "systems/c64.h"
 
@@ -14,9 +16,6 @@ namespace YAKC {
 
 class c64_t {
 public:
-    /// check if required roms are loaded
-    static bool check_roms(system model);
-
     /// power-on the device
     void poweron(system model);
     /// power-off the device
@@ -43,11 +42,57 @@ public:
     void decode_audio(float* buffer, int num_samples);
     /// file quickloading (only bin/raw files)
     bool quickload(filesystem* fs, const char* name, filetype type, bool start);
+    /// return true if the cassette motor is on
+    bool tape_motor_on() const;
+    /// write a character into the KERNAL keyboard buffer
+    paste_result paste_char(uint8_t ascii);
+    /// advance the jiffy clock while frames are skipped
+    void advance_timers(uint32_t micro_seconds);
     /// audio callback
     static void audio_cb(const float* samples, int num_samples, void* user_data);
+    /// count I/O accesses per chip register (iostats decoder)
+    static void decode_io(uint64_t pins, bool write, iostats& stats);
+
+    /// trap the KERNAL LOAD routine to instantly load standard tape blocks
+    bool fast_tape = true;
 
     ::c64_t sys;
     bool on = false;
+    /// the jiffy clock, incremented by the KERNAL interrupt handler
+    static const uint16_t timer_addr = 0x00A0;
+    static const int timer_size = 3;
+
+private:
+    /// CPU trap id for the KERNAL LOAD entry point
+    static const int load_trap_id = 3;
+    /// KERNAL LOAD entry point (behind the $0330 vector)
+    static const uint16_t load_addr = 0xF4A5;
+    /// max number of decoded tape blocks
+    static const int max_tape_blocks = 64;
+
+    /// decode the standard ROM loader blocks of a TAP file
+    void decode_tape(const uint8_t* ptr, int num_bytes);
+    /// free decoded tape data
+    void eject_tape();
+    /// called when the KERNAL LOAD trap was hit, return true if handled
+    bool trap_load();
+    /// hand the rest of the tape over to real-time playback
+    void play_rest_of_tape(int pulse_pos);
+
+    // a tape block written by the standard ROM loader
+    struct tape_block {
+        bool first_copy = false;    // false for the repeated copy
+        int data_pos = 0;           // offset into tape_bytes (after countdown)
+        int size = 0;               // payload size (without checksum)
+        int pulse_end = 0;          // pulse data offset after the block
+    };
+    tape_block tape_blocks[max_tape_blocks];
+    int num_tape_blocks = 0;
+    int cur_tape_block = 0;
+    uint8_t* tape_bytes = nullptr;  // decoded bytes of all blocks
+    uint8_t* tape_pulses = nullptr; // copy of the TAP file
+    int tape_size = 0;
+    uint32_t timer_us = 0;          // remainder for advance_timers()
 };
 extern YAKC::c64_t c64;
 
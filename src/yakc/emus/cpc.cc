@@ -8,7 +8,15 @@
 //
 //  TODO:
 //      - graphics in some demos still broken
-//      - floppy disk controller emulation and DSK file loading
+//
+//  Disc images:
+//  DSK images are parsed and validated by YAKC::dsk, which also finds
+//  the program to start in the AMSDOS directory. The floppy controller
+//  and drive are emulated by the chips upd765 and fdd, which decode the
+//  image once into a track/sector table when the disc is inserted.
+//  Transfers always run with the emulated FDC timing, yakc::fast_disc
+//  only warps the whole system while the drive motor is on.
+//  Only the CPC 6128 has a disc drive and the AMSDOS ROM.
 //------------------------------------------------------------------------------
 #include "cpc.h"
 #include "yakc/util/filetypes.h"
@@ -17,26 +25,6 @@ YAKC::cpc_t YAKC::cpc;
 
 namespace YAKC {
 
-//------------------------------------------------------------------------------
-bool
-cpc_t::check_roms(system model) {
-    if (system::cpc464 == model) {
-        return roms.has(rom_images::cpc464_os) && roms.has(rom_images::cpc464_basic);
-    }
-    else if (system::cpc6128 == model) {
-        return roms.has(rom_images::cpc6128_os) &&
-               roms.has(rom_images::cpc6128_basic) &&
-               roms.has(rom_images::cpc6128_amsdos);
-
-    }
-    else if (system::kccompact == model) {
-        return roms.has(rom_images::kcc_os) && roms.has(rom_images::kcc_basic);
-    }
-    else {
-        return false;
-    }
-}
-
 //------------------------------------------------------------------------------
 void
 cpc_t::poweron(system m) {
@@ -52,8 +40,10 @@ cpc_t::poweron(system m) {
         case system::kccompact: desc.type = CPC_TYPE_KCCOMPACT; break;
         default:                desc.type = CPC_TYPE_6128; break;
     }
+    // the video debugging mode renders the whole video frame
+    board.select_rgba8_buffer(dbg_width, dbg_height);
     desc.pixel_buffer = board.rgba8_buffer;
-    desc.pixel_buffer_size = sizeof(board.rgba8_buffer);
+    desc.pixel_buffer_size = board.rgba8_buffer_size;
     desc.audio_cb = cpc_t::audio_cb;
     desc.audio_sample_rate = board.audio_sample_rate;
     desc.video_debug_cb = cpc_t::video_debug_cb;
@@ -86,6 +76,8 @@ cpc_t::poweron(system m) {
     board.crt = &sys.crt;
     board.kbd = &sys.kbd;
     board.mem = &sys.mem;
+    board.sys_state = &sys;
+    board.sys_state_size = sizeof(sys);
 }
 
 //------------------------------------------------------------------------------
@@ -108,6 +100,7 @@ cpc_t::reset() {
 void
 cpc_t::exec(uint32_t micro_seconds) {
     YAKC_ASSERT(this->on);
+    YAKC_PROFILE_SCOPE(system);
     cpc_exec(&sys, micro_seconds);
 }
 
@@ -199,14 +192,84 @@ cpc_t::on_joystick(uint8_t mask) {
     cpc_joystick(&sys, m);
 }
 
+//------------------------------------------------------------------------------
+bool
+cpc_t::tape_motor_on() const {
+    // PPI port C bit 4 switches the cassette motor
+    return 0 != (sys.ppi.output[I8255_PORT_C] & (1<<4));
+}
+
+//------------------------------------------------------------------------------
+bool
+cpc_t::disc_motor_on() const {
+    return sys.fdd.motor_on;
+}
+
+//------------------------------------------------------------------------------
+bool
+cpc_t::has_disc() const {
+    return sys.fdd.has_disc;
+}
+
+//------------------------------------------------------------------------------
+const char*
+cpc_t::disc_boot_cmd() const {
+    return (this->has_disc() && this->boot_cmd[0]) ? this->boot_cmd : nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+cpc_t::insert_disc(const uint8_t* ptr, int num_bytes) {
+    if (system::cpc6128 != this->cur_model) {
+        return false;
+    }
+    // the file data is only valid during quickload, the fdd keeps its own copy
+    dsk disc;
+    if (!disc.open(ptr, num_bytes)) {
+        return false;
+    }
+    if (!disc.boot_cmd(this->boot_cmd, sizeof(this->boot_cmd))) {
+        this->boot_cmd[0] = 0;
+    }
+    return cpc_insert_disc(&sys, ptr, num_bytes);
+}
+
 //------------------------------------------------------------------------------
 void
 cpc_t::audio_cb(const float* samples, int num_samples, void* /*user_data*/) {
+    if (board.mute_audio) {
+        return;
+    }
+    YAKC_PROFILE_SCOPE(audio);
     for (int i = 0; i < num_samples; i++) {
         board.audiobuffer.write(samples[i]);
     }
 }
 
+//------------------------------------------------------------------------------
+void
+cpc_t::decode_io(uint64_t pins, bool write, iostats& stats) {
+    // PPI is selected by A11=0, CRTC by A14=0, the register (or CRTC
+    // function) is in A9..A8
+    const int reg = (pins >> 8) & 3;
+    if (0 == (pins & Z80_A11)) {
+        stats.add(chip::i8255, reg, write);
+        if ((2 == reg) && write) {
+            // the AY is controlled through BDIR/BC1 in PPI port C,
+            // address latch writes are counted as register 16
+            switch (Z80_GET_DATA(pins) & 0xC0) {
+                case 0xC0:  stats.add(chip::ay38910, 16, true); break;
+                case 0x80:  stats.add(chip::ay38910, board.ay38910->addr & 0x0F, true); break;
+                case 0x40:  stats.add(chip::ay38910, board.ay38910->addr & 0x0F, false); break;
+                default:    break;
+            }
+        }
+    }
+    if (0 == (pins & Z80_A14)) {
+        stats.add(chip::mc6845, reg, write);
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 cpc_t::decode_audio(float* buffer, int num_samples) {
@@ -233,16 +296,20 @@ cpc_t::quickload(filesystem* fs, const char* name, filetype type, bool start) {
     YAKC_ASSERT(on);
     bool success = false;
     int num_bytes = 0;
-    const uint8_t* ptr = (const uint8_t*) fs->get(name, num_bytes);
+    const filesystem::file fp = fs->find(name);
+    const uint8_t* ptr = (const uint8_t*) fs->get(fp, num_bytes);
     if (ptr && (num_bytes > 0)) {
         if (type == filetype::cpc_tap) {
             success = cpc_insert_tape(&sys, ptr, num_bytes);
         }
+        else if (type == filetype::cpc_dsk) {
+            success = this->insert_disc(ptr, num_bytes);
+        }
         else {
             success = cpc_quickload(&sys, ptr, num_bytes);
         }
     }
-    fs->rm(name);
+    fs->rm(fp);
     return success;
 }
 
@@ -5,18 +5,17 @@
     @brief Amstrad CPC 464/6128 and KC Compact emulation
 */
 #include "yakc/util/breadboard.h"
+#include "yakc/util/iostats.h"
 #include "yakc/util/rom_images.h"
 #include "yakc/util/filesystem.h"
 #include "yakc/util/filetypes.h"
+#include "yakc/util/dsk.h"
 #include "systems/cpc.h"
 
 namespace YAKC {
 
 class cpc_t {
 public:
-    /// check if required roms are loaded
-    static bool check_roms(system model);
-    
     /// power-on the device
     void poweron(system m);
     /// power-off the device
@@ -43,8 +42,18 @@ public:
     const void* framebuffer(int& out_width, int& out_height);
     /// file quickloading
     bool quickload(filesystem* fs, const char* name, filetype type, bool start);
+    /// return true if the cassette motor is on
+    bool tape_motor_on() const;
+    /// return true if the floppy drive motor is on
+    bool disc_motor_on() const;
+    /// return true if a disc is inserted
+    bool has_disc() const;
+    /// get the command to start the inserted disc, or nullptr
+    const char* disc_boot_cmd() const;
     /// audio callback
     static void audio_cb(const float* samples, int num_samples, void* user_data);
+    /// count I/O accesses per chip register (iostats decoder)
+    static void decode_io(uint64_t pins, bool write, iostats& stats);
     /// video debugging callback
     static void video_debug_cb(uint64_t crtc_pins, void* user_data);
 
@@ -53,6 +62,12 @@ public:
     ::cpc_t sys;
     static const int dbg_width = 1024;
     static const int dbg_height = 312;
+
+private:
+    /// insert a DSK disc image, return false if not valid
+    bool insert_disc(const uint8_t* ptr, int num_bytes);
+
+    char boot_cmd[16] = { };
 };
 extern YAKC::cpc_t cpc;
 
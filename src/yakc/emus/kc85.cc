@@ -8,35 +8,6 @@ YAKC::kc85_t YAKC::kc85;
 
 namespace YAKC {
 
-//------------------------------------------------------------------------------
-bool
-kc85_t::check_roms(system model, os_rom os) {
-    if (system::kc85_2 == model) {
-        if (os_rom::caos_hc900 == os) {
-            return roms.has(rom_images::hc900);
-        }
-        else if (os_rom::caos_2_2 == os) {
-            return roms.has(rom_images::caos22);
-        }
-    }
-    else if (system::kc85_3 == model) {
-        if (os_rom::caos_3_1 == os) {
-            return roms.has(rom_images::caos31) && roms.has(rom_images::kc85_basic_rom);
-        }
-        else if (os_rom::caos_3_4 == os) {
-            return roms.has(rom_images::caos34) && roms.has(rom_images::kc85_basic_rom);
-        }
-    }
-    else if (system::kc85_4 == model) {
-        if (os_rom::caos_4_2 == os) {
-            return roms.has(rom_images::caos42c) &&
-                   roms.has(rom_images::caos42e) &&
-                   roms.has(rom_images::kc85_basic_rom);
-        }
-    }
-    return false;
-}
-
 //------------------------------------------------------------------------------
 void
 kc85_t::poweron(system m, os_rom os) {
@@ -51,8 +22,9 @@ kc85_t::poweron(system m, os_rom os) {
         case system::kc85_3: desc.type = KC85_TYPE_3; break;
         default:             desc.type = KC85_TYPE_4; break;
     }
+    board.select_rgba8_buffer(KC85_DISPLAY_WIDTH, KC85_DISPLAY_HEIGHT);
     desc.pixel_buffer = board.rgba8_buffer;
-    desc.pixel_buffer_size = sizeof(board.rgba8_buffer);
+    desc.pixel_buffer_size = board.rgba8_buffer_size;
     desc.audio_cb = kc85_t::audio_cb;
     desc.audio_sample_rate = board.audio_sample_rate;
     desc.patch_cb = kc85_t::patch_cb;
@@ -95,6 +67,8 @@ kc85_t::poweron(system m, os_rom os) {
     board.beeper_2 = &sys.beeper_2;
     board.kbd = &sys.kbd;
     board.mem = &sys.mem;
+    board.sys_state = &sys;
+    board.sys_state_size = sizeof(sys);
 }
 
 //------------------------------------------------------------------------------
@@ -117,6 +91,7 @@ kc85_t::reset() {
 void
 kc85_t::exec(uint32_t micro_seconds) {
     YAKC_ASSERT(on);
+    YAKC_PROFILE_SCOPE(system);
     kc85_exec(&sys, micro_seconds);
 }
 
@@ -151,11 +126,30 @@ kc85_t::decode_audio(float* buffer, int num_samples) {
 //------------------------------------------------------------------------------
 void
 kc85_t::audio_cb(const float* samples, int num_samples, void* /*user_data*/) {
+    if (board.mute_audio) {
+        return;
+    }
+    YAKC_PROFILE_SCOPE(audio);
     for (int i = 0; i < num_samples; i++) {
         board.audiobuffer.write(samples[i]);
     }
 }
 
+//------------------------------------------------------------------------------
+void
+kc85_t::decode_io(uint64_t pins, bool write, iostats& stats) {
+    // PIO at ports 0x88..0x8B, CTC at 0x8C..0x8F
+    const uint8_t port = pins & 0xFF;
+    if ((port & 0xF8) == 0x88) {
+        if (port & 4) {
+            stats.add(chip::z80ctc, port & 3, write);
+        }
+        else {
+            stats.add(chip::z80pio, port & 3, write);
+        }
+    }
+}
+
 //------------------------------------------------------------------------------
 const void*
 kc85_t::framebuffer(int& out_width, int& out_height) {
@@ -193,11 +187,12 @@ kc85_t::quickload(filesystem* fs, const char* name, filetype type, bool start) {
     YAKC_ASSERT(on);
     bool success = false;
     int num_bytes = 0;
-    const uint8_t* ptr = (const uint8_t*) fs->get(name, num_bytes);
+    const filesystem::file fp = fs->find(name);
+    const uint8_t* ptr = (const uint8_t*) fs->get(fp, num_bytes);
     if (ptr && (num_bytes > 0)) {
         success = kc85_quickload(&sys, ptr, num_bytes);
     }
-    fs->rm(name);
+    fs->rm(fp);
     return success;
 }
 
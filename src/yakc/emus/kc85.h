@@ -5,6 +5,7 @@
     @brief wrapper class for the KC85/2, /3, /4
 */
 #include "yakc/util/breadboard.h"
+#include "yakc/util/iostats.h"
 #include "yakc/util/rom_images.h"
 #include "yakc/util/filesystem.h"
 #include "yakc/util/filetypes.h"
@@ -14,9 +15,6 @@ namespace YAKC {
 
 class kc85_t {
 public:
-    /// check if required roms are loaded
-    static bool check_roms(system model, os_rom os);
-
     /// power-on the device
     void poweron(system m, os_rom os);
     /// power-off the device
@@ -43,6 +41,8 @@ public:
     bool quickload(filesystem* fs, const char* name, filetype type, bool start);
     /// audio callback
     static void audio_cb(const float* samples, int num_samples, void* user_data);
+    /// count I/O accesses per chip register (iostats decoder)
+    static void decode_io(uint64_t pins, bool write, iostats& stats);
     /// callback to apply patches after a snapshot is loaded
     static void patch_cb(const char* snapshot_name, void* user_data);
 
@@ -9,17 +9,6 @@ YAKC::z1013_t YAKC::z1013;
 
 namespace YAKC {
 
-//------------------------------------------------------------------------------
-bool
-z1013_t::check_roms(system model) {
-    if (system::z1013_01 == model) {
-        return roms.has(rom_images::z1013_mon202) && roms.has(rom_images::z1013_font);
-    }
-    else {
-        return roms.has(rom_images::z1013_mon_a2) && roms.has(rom_images::z1013_font);
-    }
-}
-
 //------------------------------------------------------------------------------
 void
 z1013_t::poweron(system m) {
@@ -41,8 +30,9 @@ z1013_t::poweron(system m) {
             desc.type = Z1013_TYPE_64;
             break;
     }
+    board.select_rgba8_buffer(Z1013_DISPLAY_WIDTH, Z1013_DISPLAY_HEIGHT);
     desc.pixel_buffer = board.rgba8_buffer;
-    desc.pixel_buffer_size = sizeof(board.rgba8_buffer);
+    desc.pixel_buffer_size = board.rgba8_buffer_size;
     if (system::z1013_01 == m) {
         desc.rom_mon202 = roms.ptr(rom_images::z1013_mon202);
         desc.rom_mon202_size = roms.size(rom_images::z1013_mon202);
@@ -59,6 +49,8 @@ z1013_t::poweron(system m) {
     board.z80pio_1 = &sys.pio;
     board.kbd = &sys.kbd;
     board.mem = &sys.mem;
+    board.sys_state = &sys;
+    board.sys_state_size = sizeof(sys);
 }
 
 //------------------------------------------------------------------------------
@@ -81,6 +73,7 @@ z1013_t::reset() {
 void
 z1013_t::exec(uint32_t micro_seconds) {
     YAKC_ASSERT(this->on);
+    YAKC_PROFILE_SCOPE(system);
     z1013_exec(&sys, micro_seconds);
 }
 
@@ -111,17 +104,29 @@ z1013_t::framebuffer(int& out_width, int& out_height) {
     return board.rgba8_buffer;
 }
 
+//------------------------------------------------------------------------------
+void
+z1013_t::decode_io(uint64_t pins, bool write, iostats& stats) {
+    // PIO at ports 0x00..0x03 (A0: control/data, A1: port B/A), the
+    // register index is normalized to the KC85 order (A0: B/A, A1: C/D)
+    const uint8_t port = pins & 0xFF;
+    if ((port & 0xFC) == 0x00) {
+        stats.add(chip::z80pio, ((port & 1)<<1) | ((port>>1) & 1), write);
+    }
+}
+
 //------------------------------------------------------------------------------
 bool
 z1013_t::quickload(filesystem* fs, const char* name, filetype type, bool start) {
     YAKC_ASSERT(on);
     bool success = false;
     int num_bytes = 0;
-    const uint8_t* ptr = (const uint8_t*) fs->get(name, num_bytes);
+    const filesystem::file fp = fs->find(name);
+    const uint8_t* ptr = (const uint8_t*) fs->get(fp, num_bytes);
     if (ptr && (num_bytes > 0)) {
         success = z1013_quickload(&sys, ptr, num_bytes);
     }
-    fs->rm(name);
+    fs->rm(fp);
     return success;
 }
 
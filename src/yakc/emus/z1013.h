@@ -34,6 +34,7 @@
     can require more than one key to be set (e.g. shift keys).
 */
 #include "yakc/util/breadboard.h"
+#include "yakc/util/iostats.h"
 #include "yakc/util/rom_images.h"
 #include "yakc/util/filesystem.h"
 #include "yakc/util/filetypes.h"
@@ -43,9 +44,6 @@ namespace YAKC {
 
 class z1013_t {
 public:
-    /// check if required roms are loaded
-    static bool check_roms(system model);
-
     /// power-on the device
     void poweron(system m);
     /// power-off the device
@@ -70,6 +68,8 @@ public:
     bool quickload(filesystem* fs, const char* name, filetype type, bool start);
     /// audio callback
     static void audio_cb(const float* samples, int num_samples, void* user_data);
+    /// count I/O accesses per chip register (iostats decoder)
+    static void decode_io(uint64_t pins, bool write, iostats& stats);
 
     ::z1013_t sys;
     system cur_model = system::none;
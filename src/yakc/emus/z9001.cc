@@ -8,25 +8,6 @@ YAKC::z9001_t YAKC::z9001;
 
 namespace YAKC {
 
-//------------------------------------------------------------------------------
-bool
-z9001_t::check_roms(system model) {
-    if (system::z9001 == model) {
-        return roms.has(rom_images::z9001_os12_1) &&
-               roms.has(rom_images::z9001_os12_2) &&
-               roms.has(rom_images::z9001_basic_507_511) &&
-               roms.has(rom_images::z9001_font);
-    }
-    else if (system::kc87 == model) {
-        return roms.has(rom_images::kc87_os_2) &&
-               roms.has(rom_images::z9001_basic) &&
-               roms.has(rom_images::kc87_font_2);
-    }
-    else {
-        return false;
-    }
-}
-
 //------------------------------------------------------------------------------
 void
 z9001_t::poweron(system m) {
@@ -38,8 +19,9 @@ z9001_t::poweron(system m) {
 
     z9001_desc_t desc = {};
     desc.type = (m == system::z9001) ? Z9001_TYPE_Z9001 : Z9001_TYPE_KC87;
+    board.select_rgba8_buffer(Z9001_DISPLAY_WIDTH, Z9001_DISPLAY_HEIGHT);
     desc.pixel_buffer = board.rgba8_buffer;
-    desc.pixel_buffer_size = sizeof(board.rgba8_buffer);
+    desc.pixel_buffer_size = board.rgba8_buffer_size;
     desc.audio_cb = z9001_t::audio_cb;
     desc.audio_sample_rate = board.audio_sample_rate;
     if (m == system::z9001) {
@@ -69,6 +51,8 @@ z9001_t::poweron(system m) {
     board.beeper_1 = &sys.beeper;
     board.kbd = &sys.kbd;
     board.mem = &sys.mem;
+    board.sys_state = &sys;
+    board.sys_state_size = sizeof(sys);
 }
 
 //------------------------------------------------------------------------------
@@ -91,6 +75,7 @@ z9001_t::reset() {
 void
 z9001_t::exec(uint32_t micro_seconds) {
     YAKC_ASSERT(this->on);
+    YAKC_PROFILE_SCOPE(system);
     z9001_exec(&sys, micro_seconds);
 }
 
@@ -119,11 +104,28 @@ z9001_t::on_key_up(uint8_t key) {
 //------------------------------------------------------------------------------
 void
 z9001_t::audio_cb(const float* samples, int num_samples, void* /*user_data*/) {
+    if (board.mute_audio) {
+        return;
+    }
+    YAKC_PROFILE_SCOPE(audio);
     for (int i = 0; i < num_samples; i++) {
         board.audiobuffer.write(samples[i]);
     }
 }
 
+//------------------------------------------------------------------------------
+void
+z9001_t::decode_io(uint64_t pins, bool write, iostats& stats) {
+    // CTC at ports 0x80..0x87, PIO1 at 0x88..0x8F, PIO2 at 0x90..0x97
+    const uint8_t port = pins & 0xFF;
+    switch (port & 0xF8) {
+        case 0x80:  stats.add(chip::z80ctc, port & 3, write); break;
+        case 0x88:  stats.add(chip::z80pio, port & 3, write); break;
+        case 0x90:  stats.add(chip::z80pio_2, port & 3, write); break;
+        default:    break;
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 z9001_t::decode_audio(float* buffer, int num_samples) {
@@ -144,11 +146,12 @@ z9001_t::quickload(filesystem* fs, const char* name, filetype type, bool start)
     YAKC_ASSERT(on);
     bool success = false;
     int num_bytes = 0;
-    const uint8_t* ptr = (const uint8_t*) fs->get(name, num_bytes);
+    const filesystem::file fp = fs->find(name);
+    const uint8_t* ptr = (const uint8_t*) fs->get(fp, num_bytes);
     if (ptr && (num_bytes > 0)) {
         success = z9001_quickload(&sys, ptr, num_bytes);
     }
-    fs->rm(name);
+    fs->rm(fp);
     return success;
 }
 
@@ -16,6 +16,7 @@
         http://www.sax.de/~zander/z9001/z9sch_1.pdf
 */
 #include "yakc/util/breadboard.h"
+#include "yakc/util/iostats.h"
 #include "yakc/util/rom_images.h"
 #include "yakc/util/filesystem.h"
 #include "yakc/util/filetypes.h"
@@ -25,9 +26,6 @@ namespace YAKC {
 
 class z9001_t {
 public:
-    /// check if required roms are loaded
-    static bool check_roms(system model);
-
     /// power-on the device
     void poweron(system m);
     /// power-off the device
@@ -54,6 +52,8 @@ public:
     bool quickload(filesystem* fs, const char* name, filetype type, bool start);
     /// audio callback
     static void audio_cb(const float* samples, int num_samples, void* user_data);
+    /// count I/O accesses per chip register (iostats decoder)
+    static void decode_io(uint64_t pins, bool write, iostats& stats);
 
     system cur_model = system::kc87;
     bool on = false;
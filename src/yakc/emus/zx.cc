@@ -9,26 +9,27 @@
 //  https://www.worldofspectrum.org/faq/reference/48kreference.htm
 //  https://www.worldofspectrum.org/faq/reference/128kreference.htm
 //  http://problemkaputt.de/zxdocs.htm
+//
+//  Tape loading:
+//  TAP files contain the data blocks written by the ROM SA-BYTES routine.
+//  With fast_tape enabled, the ROM LD-BYTES routine is trapped and the
+//  next block is copied directly into memory, after that the rest of the
+//  tape is played back in real time for programs with a custom loader
+//  (and the trap is removed, since the ROM loader now reads the pulses).
+//  Without fast_tape, the whole tape is played back in real time, the
+//  tape pulses are generated on the fly and fed into the EAR bit of
+//  the ULA port through the tick hook. The pulse lengths are defined in
+//  48K T-states and scaled to the faster CPU clock of the 128K.
+//  Tape encoding: https://www.worldofspectrum.org/faq/reference/48kreference.htm#TapeDataStructure
 //------------------------------------------------------------------------------
 #include "zx.h"
 #include "yakc/util/filetypes.h"
+#include <string.h>
 
 YAKC::zx_t YAKC::zx;
 
 namespace YAKC {
 
-//------------------------------------------------------------------------------
-bool
-zx_t::check_roms(system model) {
-    if (system::zxspectrum48k == model) {
-        return roms.has(rom_images::zx48k);
-    }
-    else if (system::zxspectrum128k == model) {
-        return roms.has(rom_images::zx128k_0) && roms.has(rom_images::zx128k_1);
-    }
-    return false;
-}
-
 //------------------------------------------------------------------------------
 void
 zx_t::poweron(system m) {
@@ -40,8 +41,9 @@ zx_t::poweron(system m) {
 
     zx_desc_t desc = {};
     desc.type = (m == system::zxspectrum48k) ? ZX_TYPE_48K : ZX_TYPE_128;
+    board.select_rgba8_buffer(ZX_DISPLAY_WIDTH, ZX_DISPLAY_HEIGHT);
     desc.pixel_buffer = board.rgba8_buffer;
-    desc.pixel_buffer_size = sizeof(board.rgba8_buffer);
+    desc.pixel_buffer_size = board.rgba8_buffer_size;
     desc.audio_cb = zx_t::audio_cb;
     desc.audio_sample_rate = board.audio_sample_rate;
     if (m == system::zxspectrum48k) {
@@ -61,12 +63,15 @@ zx_t::poweron(system m) {
     board.beeper_1 = &sys.beeper;
     board.kbd = &sys.kbd;
     board.mem = &sys.mem;
+    board.sys_state = &sys;
+    board.sys_state_size = sizeof(sys);
 }
 
 //------------------------------------------------------------------------------
 void
 zx_t::poweroff() {
     YAKC_ASSERT(this->on);
+    this->eject_tape();
     this->on = false;
     zx_discard(&sys);
     board.clear();
@@ -83,7 +88,14 @@ zx_t::reset() {
 void
 zx_t::exec(uint32_t micro_seconds) {
     YAKC_ASSERT(this->on);
+    YAKC_PROFILE_SCOPE(system);
     zx_exec(&sys, micro_seconds);
+    if (sys.cpu.trap_id == ld_bytes_trap_id) {
+        this->trap_ld_bytes();
+    }
+    if (this->tape && (tape_end == this->phase)) {
+        this->eject_tape();
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -140,11 +152,31 @@ zx_t::decode_audio(float* buffer, int num_samples) {
 //------------------------------------------------------------------------------
 void
 zx_t::audio_cb(const float* samples, int num_samples, void* /*user_data*/) {
+    if (board.mute_audio) {
+        return;
+    }
+    YAKC_PROFILE_SCOPE(audio);
     for (int i = 0; i < num_samples; i++) {
         board.audiobuffer.write(samples[i]);
     }
 }
 
+//------------------------------------------------------------------------------
+void
+zx_t::decode_io(uint64_t pins, bool write, iostats& stats) {
+    // ZX128 AY-3-8912: 0xFFFD selects a register (or reads it), 0xBFFD writes
+    // it, register accesses are counted per selected AY register, and
+    // address latch writes as register 16
+    if (board.ay38910 && ((pins & (Z80_A15|Z80_A1)) == Z80_A15)) {
+        if ((pins & Z80_A14) && write) {
+            stats.add(chip::ay38910, 16, write);
+        }
+        else {
+            stats.add(chip::ay38910, board.ay38910->addr & 0x0F, write);
+        }
+    }
+}
+
 //------------------------------------------------------------------------------
 const void*
 zx_t::framebuffer(int& out_width, int& out_height) {
@@ -159,14 +191,271 @@ zx_t::quickload(filesystem* fs, const char* name, filetype type, bool start) {
     YAKC_ASSERT(on);
     bool success = false;
     int num_bytes = 0;
-    const uint8_t* ptr = (const uint8_t*) fs->get(name, num_bytes);
+    const filesystem::file fp = fs->find(name);
+    const uint8_t* ptr = (const uint8_t*) fs->get(fp, num_bytes);
     if (ptr && (num_bytes > 0)) {
-        success = zx_quickload(&sys, ptr, num_bytes);
+        if (type == filetype::zx_tap) {
+            success = this->insert_tape(ptr, num_bytes);
+        }
+        else {
+            success = zx_quickload(&sys, ptr, num_bytes);
+        }
     }
-    fs->rm(name);
+    fs->rm(fp);
     return success;
 }
 
+//------------------------------------------------------------------------------
+bool
+zx_t::tape_motor_on() const {
+    return this->tape_playing;
+}
+
+//------------------------------------------------------------------------------
+void
+zx_t::advance_timers(uint32_t micro_seconds) {
+    YAKC_ASSERT(this->on);
+    // FRAMES (little endian) counts at 50 Hz
+    this->timer_us += micro_seconds;
+    const uint32_t frames = this->timer_us / 20000;
+    if (frames > 0) {
+        this->timer_us -= frames * 20000;
+        mem_t* mem = &sys.mem;
+        uint32_t val = mem_rd(mem, timer_addr) | (mem_rd(mem, timer_addr+1)<<8) | (mem_rd(mem, timer_addr+2)<<16);
+        val += frames;
+        mem_wr(mem, timer_addr, val);
+        mem_wr(mem, timer_addr+1, val>>8);
+        mem_wr(mem, timer_addr+2, val>>16);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+zx_t::insert_tape(const uint8_t* ptr, int num_bytes) {
+    this->eject_tape();
+
+    // a TAP file is a sequence of blocks, each prefixed with a 16-bit length
+    int pos = 0;
+    int num_blocks = 0;
+    while ((pos + 2) <= num_bytes) {
+        pos += 2 + (ptr[pos] | (ptr[pos+1]<<8));
+        num_blocks++;
+    }
+    if ((0 == num_blocks) || (pos != num_bytes)) {
+        return false;
+    }
+    this->tape = (uint8_t*) YAKC_MALLOC(num_bytes);
+    memcpy(this->tape, ptr, num_bytes);
+    this->tape_size = num_bytes;
+    this->start_tape_block(0);
+    if (this->fast_tape) {
+        // playback starts after the first block has been loaded through the trap
+        z80_set_trap(&sys.cpu, ld_bytes_trap_id, ld_bytes_addr);
+    }
+    else {
+        this->tape_playing = true;
+        board.tickhook.set_input(tape_input, this);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+zx_t::eject_tape() {
+    if (this->tape) {
+        YAKC_FREE(this->tape);
+        this->tape = nullptr;
+    }
+    this->tape_size = 0;
+    this->block_pos = 0;
+    this->block_len = 0;
+    this->phase = tape_end;
+    this->pulse_count = 0;
+    this->pulse_ticks = 0;
+    this->ear = false;
+    if (this->on) {
+        z80_clear_trap(&sys.cpu, ld_bytes_trap_id);
+    }
+    if (this->tape_playing) {
+        this->tape_playing = false;
+        board.tickhook.set_input(nullptr, nullptr);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+zx_t::start_tape_block(int pos) {
+    if ((pos + 2) > this->tape_size) {
+        this->phase = tape_end;
+        return false;
+    }
+    this->block_pos = pos;
+    this->block_len = this->tape[pos] | (this->tape[pos+1]<<8);
+    // header blocks (flag byte < 0x80) have a longer pilot tone
+    const bool header = (this->block_len > 0) && (this->tape[pos+2] < 0x80);
+    this->phase = tape_pilot;
+    this->pulse_count = header ? header_pilot_pulses : data_pilot_pulses;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int
+zx_t::next_tape_pulse() {
+    switch (this->phase) {
+        case tape_pilot:
+            if (--this->pulse_count == 0) {
+                this->phase = tape_sync1;
+            }
+            this->ear = !this->ear;
+            return this->tape_ticks(pilot_pulse);
+        case tape_sync1:
+            this->phase = tape_sync2;
+            this->ear = !this->ear;
+            return this->tape_ticks(sync1_pulse);
+        case tape_sync2:
+            // each bit is encoded as 2 pulses, MSB first
+            this->pulse_count = this->block_len * 16;
+            this->phase = (this->pulse_count > 0) ? tape_data : tape_pause;
+            this->ear = !this->ear;
+            return this->tape_ticks(sync2_pulse);
+        case tape_data:
+            {
+                const int bit_index = (this->block_len * 16 - this->pulse_count) / 2;
+                const uint8_t byte = this->tape[this->block_pos + 2 + (bit_index >> 3)];
+                const bool one = 0 != (byte & (0x80 >> (bit_index & 7)));
+                if (--this->pulse_count == 0) {
+                    this->phase = tape_pause;
+                }
+                this->ear = !this->ear;
+                return this->tape_ticks(one ? bit1_pulse : bit0_pulse);
+            }
+        case tape_pause:
+            // a silent gap, then the next block
+            this->ear = false;
+            this->start_tape_block(this->block_pos + 2 + this->block_len);
+            return this->tape_ticks(pause_ticks);
+        default:
+            return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+zx_t::tape_ticks(int ticks_48k) const {
+    if (system::zxspectrum128k == this->cur_model) {
+        return int((int64_t(ticks_48k) * freq_128k) / freq_48k);
+    }
+    else {
+        return ticks_48k;
+    }
+}
+
+//------------------------------------------------------------------------------
+uint64_t
+zx_t::tape_input(int num_ticks, uint64_t pins, void* user_data) {
+    zx_t* self = (zx_t*) user_data;
+    if (self->tape_playing) {
+        self->pulse_ticks -= num_ticks;
+        while ((self->pulse_ticks <= 0) && (tape_end != self->phase)) {
+            self->pulse_ticks += self->next_tape_pulse();
+        }
+        // reading the ULA port (any even port address) returns the EAR input in bit 6
+        if (((pins & (Z80_IORQ|Z80_RD)) == (Z80_IORQ|Z80_RD)) && !(pins & Z80_A0)) {
+            uint8_t data = Z80_GET_DATA(pins);
+            if (self->ear) {
+                data |= (1<<6);
+            }
+            else {
+                data &= ~(1<<6);
+            }
+            Z80_SET_DATA(pins, data);
+        }
+    }
+    return pins;
+}
+
+//------------------------------------------------------------------------------
+bool
+zx_t::trap_ld_bytes() {
+    // on the 128K, LD-BYTES lives in ROM 1 (the 48K BASIC ROM)
+    if ((system::zxspectrum128k == this->cur_model) && !(sys.last_mem_config & (1<<4))) {
+        return false;
+    }
+    if (!this->tape || (tape_end == this->phase)) {
+        return false;
+    }
+    // the trap is only armed until real-time playback starts
+    YAKC_ASSERT(!this->tape_playing);
+    const int pos = this->block_pos;
+    if ((pos + 2) > this->tape_size) {
+        this->eject_tape();
+        return false;
+    }
+    const int len = this->tape[pos] | (this->tape[pos+1]<<8);
+    const uint8_t* blk = this->tape + pos + 2;
+
+    // on entry: A is the expected flag byte, carry flag set for LOAD
+    // (cleared for VERIFY), IX is the start address and DE the length
+    z80_t* cpu = &sys.cpu;
+    mem_t* mem = &sys.mem;
+    const uint8_t a = z80_af(cpu) >> 8;
+    uint8_t f = z80_af(cpu) & 0xFF;
+    const bool load = 0 != (f & Z80_CF);
+    uint16_t ix = z80_ix(cpu);
+    uint16_t de = z80_de(cpu);
+    const int num_bytes = de;
+    bool ok = false;
+    if ((len > 0) && (blk[0] == a)) {
+        // the XOR of flag byte, data bytes and checksum must be 0
+        uint8_t parity = blk[0];
+        const int avail = len - 1;
+        ok = true;
+        int i = 0;
+        for (; (i < num_bytes) && (i < avail); i++) {
+            const uint8_t val = blk[1 + i];
+            if (load) {
+                mem_wr(mem, ix, val);
+            }
+            else if (mem_rd(mem, ix) != val) {
+                ok = false;
+            }
+            parity ^= val;
+            ix++;
+            de--;
+        }
+        if (i < avail) {
+            parity ^= blk[1 + i];
+            ok = ok && (0 == parity) && (0 == de);
+        }
+        else {
+            ok = false;
+        }
+    }
+    z80_set_ix(cpu, ix);
+    z80_set_de(cpu, de);
+    f = ok ? (f | Z80_CF) : (f & ~Z80_CF);
+    z80_set_af(cpu, (a<<8) | f);
+
+    // return to the caller, the ROM enables interrupts when leaving LD-BYTES
+    z80_set_iff1(cpu, true);
+    z80_set_iff2(cpu, true);
+    const uint16_t sp = z80_sp(cpu);
+    z80_set_pc(cpu, mem_rd(mem, sp) | (mem_rd(mem, sp + 1)<<8));
+    z80_set_sp(cpu, sp + 2);
+
+    // continue real-time playback with the next block, the trap is
+    // removed, otherwise a ROM loader called during playback would
+    // skip the block which is currently played
+    if (this->start_tape_block(pos + 2 + len)) {
+        this->ear = false;
+        this->pulse_ticks = this->tape_ticks(pause_ticks);
+        z80_clear_trap(&sys.cpu, ld_bytes_trap_id);
+        this->tape_playing = true;
+        board.tickhook.set_input(tape_input, this);
+    }
+    return true;
+}
+
 //------------------------------------------------------------------------------
 const char*
 zx_t::system_info() const {
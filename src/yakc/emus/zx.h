@@ -5,6 +5,7 @@
     @brief Sinclair ZX Spectrum 48K/128K emulation
 */
 #include "yakc/util/breadboard.h"
+#include "yakc/util/iostats.h"
 #include "yakc/util/rom_images.h"
 #include "yakc/util/filesystem.h"
 #include "yakc/util/filetypes.h"
@@ -14,9 +15,6 @@ namespace YAKC {
 
 class zx_t {
 public:
-    /// check if required roms are loaded
-    static bool check_roms(system model);
-    
     /// power-on the device
     void poweron(system m);
     /// power-off the device
@@ -42,13 +40,78 @@ public:
     /// get framebuffer, width and height
     const void* framebuffer(int& out_width, int& out_height);
     /// file quickloading
-    bool quickload(filesystem* fs, const char* name, filetype type, bool start);    
+    bool quickload(filesystem* fs, const char* name, filetype type, bool start);
+    /// return true while the tape is playing in real time
+    bool tape_motor_on() const;
+    /// advance the frame counter while frames are skipped
+    void advance_timers(uint32_t micro_seconds);
     /// audio callback
     static void audio_cb(const float* samples, int num_samples, void* user_data);
+    /// count I/O accesses per chip register (iostats decoder)
+    static void decode_io(uint64_t pins, bool write, iostats& stats);
+
+    /// trap the ROM LD-BYTES routine to instantly load standard tape blocks
+    bool fast_tape = true;
 
     system cur_model = system::zxspectrum48k;
     bool on = false;
     ::zx_t sys;
+    /// the FRAMES system variable, incremented by the ROM interrupt handler
+    static const uint16_t timer_addr = 0x5C78;
+    static const int timer_size = 3;
+
+private:
+    /// CPU trap id for the LD-BYTES entry point
+    static const int ld_bytes_trap_id = 3;
+    /// LD-BYTES entry point in the 48K ROM (and 128K ROM 1)
+    static const uint16_t ld_bytes_addr = 0x0556;
+
+    /// tape pulse lengths in T-states of the 48K (3.5 MHz), scaled by tape_ticks()
+    static const int pilot_pulse = 2168;
+    static const int sync1_pulse = 667;
+    static const int sync2_pulse = 735;
+    static const int bit0_pulse = 855;
+    static const int bit1_pulse = 1710;
+    static const int header_pilot_pulses = 8063;
+    static const int data_pilot_pulses = 3223;
+    static const int pause_ticks = 3500000;
+    /// CPU clock frequencies of the 48K and 128K in Hz
+    static const int freq_48k = 3500000;
+    static const int freq_128k = 3546900;
+
+    /// insert a TAP file, return false if the file isn't valid
+    bool insert_tape(const uint8_t* ptr, int num_bytes);
+    /// remove the tape and stop playback
+    void eject_tape();
+    /// called when the LD-BYTES trap was hit, return true if handled
+    bool trap_ld_bytes();
+    /// setup playback of the tape block at a TAP file offset
+    bool start_tape_block(int pos);
+    /// advance tape playback to the next pulse, return its length in T-states
+    int next_tape_pulse();
+    /// convert 48K T-states into T-states of the current model
+    int tape_ticks(int ticks_48k) const;
+    /// tick hook input callback to feed the tape signal into the ULA port
+    static uint64_t tape_input(int num_ticks, uint64_t pins, void* user_data);
+
+    enum tape_phase {
+        tape_pilot,
+        tape_sync1,
+        tape_sync2,
+        tape_data,
+        tape_pause,
+        tape_end,
+    };
+    uint8_t* tape = nullptr;        // copy of the TAP file
+    int tape_size = 0;
+    int block_pos = 0;              // TAP file offset of current block
+    int block_len = 0;              // length of current block (flag+data+checksum)
+    bool tape_playing = false;      // tape is played back in real time
+    tape_phase phase = tape_end;
+    int pulse_count = 0;            // remaining pulses in current phase
+    int pulse_ticks = 0;            // remaining T-states of current pulse
+    bool ear = false;               // current EAR input level
+    uint32_t timer_us = 0;          // remainder for advance_timers()
 };
 extern YAKC::zx_t zx;
 
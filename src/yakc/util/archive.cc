@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------
+//  archive.cc
+//------------------------------------------------------------------------------
+#include "archive.h"
+#include "zlib.h"
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+bool
+archive::open(const uint8_t* ptr, int size) {
+    YAKC_ASSERT(ptr);
+    this->close();
+    if (size < (int)sizeof(header)) {
+        return false;
+    }
+    const header* hdr = (const header*) ptr;
+    if ((0 != memcmp(hdr->magic, "YPAK", 4)) || (hdr->version != version)) {
+        return false;
+    }
+    const int toc_end = sizeof(header) + hdr->num_entries * sizeof(toc_entry);
+    if ((hdr->num_entries > 0xFFFF) || (toc_end > size)) {
+        return false;
+    }
+    const toc_entry* entries = (const toc_entry*) (ptr + sizeof(header));
+    for (uint32_t i = 0; i < hdr->num_entries; i++) {
+        const toc_entry& e = entries[i];
+        if ((0 != e.name[sizeof(e.name)-1]) || (0 != e.type[sizeof(e.type)-1])) {
+            return false;
+        }
+        if ((e.offset < (uint32_t)toc_end) || (e.packed_size > (uint32_t)size) || (e.offset > (uint32_t)(size - e.packed_size))) {
+            return false;
+        }
+        if ((i > 0) && (strcmp(entries[i-1].name, e.name) >= 0)) {
+            // table of contents must be sorted for binary search
+            return false;
+        }
+    }
+    this->data = ptr;
+    this->data_size = size;
+    this->toc = entries;
+    this->num = hdr->num_entries;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+archive::close() {
+    this->data = nullptr;
+    this->data_size = 0;
+    this->toc = nullptr;
+    this->num = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+archive::is_open() const {
+    return nullptr != this->data;
+}
+
+//------------------------------------------------------------------------------
+int
+archive::num_entries() const {
+    return this->num;
+}
+
+//------------------------------------------------------------------------------
+const archive::toc_entry&
+archive::entry(int index) const {
+    YAKC_ASSERT((index >= 0) && (index < this->num));
+    return this->toc[index];
+}
+
+//------------------------------------------------------------------------------
+int
+archive::find(const char* name) const {
+    YAKC_ASSERT(name);
+    int lo = 0;
+    int hi = this->num - 1;
+    while (lo <= hi) {
+        const int mid = (lo + hi) / 2;
+        const int cmp = strcmp(this->toc[mid].name, name);
+        if (0 == cmp) {
+            return mid;
+        }
+        else if (cmp < 0) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid - 1;
+        }
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+const char*
+archive::name(int index) const {
+    return this->entry(index).name;
+}
+
+//------------------------------------------------------------------------------
+int
+archive::size(int index) const {
+    return this->entry(index).size;
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+archive::hash(int index) const {
+    return this->entry(index).crc32;
+}
+
+//------------------------------------------------------------------------------
+filetype
+archive::type(int index) const {
+    return filetype_from_string(this->entry(index).type);
+}
+
+//------------------------------------------------------------------------------
+system
+archive::compat(int index) const {
+    return (system) this->entry(index).compat;
+}
+
+//------------------------------------------------------------------------------
+bool
+archive::extract(int index, uint8_t* dst, int dst_size) const {
+    YAKC_ASSERT(dst);
+    const toc_entry& e = this->entry(index);
+    if ((uint32_t)dst_size < e.size) {
+        return false;
+    }
+    const uint8_t* src = this->data + e.offset;
+    if (e.packed_size == e.size) {
+        memcpy(dst, src, e.size);
+    }
+    else {
+        uLongf dst_len = e.size;
+        if ((Z_OK != uncompress(dst, &dst_len, src, e.packed_size)) || (dst_len != e.size)) {
+            return false;
+        }
+    }
+    return e.crc32 == (uint32_t) crc32(0, dst, e.size);
+}
+
+} // namespace YAKC
@@ -0,0 +1,80 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::archive
+    @brief read-only access to a packed ROM and software archive
+
+    An archive bundles many ROM images and program files into a single
+    blob which can be fetched with one request. It starts with a header,
+    followed by a table of contents sorted by file name, followed by
+    the zlib-compressed file data. Entries which don't compress well are
+    stored uncompressed (packed size equals size).
+
+    Entries are looked up by binary search in the table of contents,
+    and only decompressed when extracted. The archive doesn't own the
+    data blob, it must remain valid until the archive is closed.
+
+    Archives are created with the 'fips pack' verb. All values are
+    stored little-endian.
+*/
+#include "yakc/util/core.h"
+#include "yakc/util/filetypes.h"
+
+namespace YAKC {
+
+class archive {
+public:
+    /// archive header
+    struct header {
+        char magic[4];          // 'YPAK'
+        uint32_t version;
+        uint32_t num_entries;
+        uint32_t reserved;
+    };
+    /// table of contents entry
+    struct toc_entry {
+        char name[32];          // zero-terminated file name
+        char type[12];          // zero-terminated filetype name (see filetype_from_string)
+        uint32_t compat;        // system bitmask
+        uint32_t offset;        // offset of packed data from start of archive
+        uint32_t packed_size;
+        uint32_t size;
+        uint32_t crc32;         // CRC32 of the uncompressed data
+    };
+    /// current archive version
+    static const uint32_t version = 1;
+
+    /// open an archive from a data blob (data must remain valid), return false if not valid
+    bool open(const uint8_t* ptr, int size);
+    /// close the archive
+    void close();
+    /// return true if an archive is open
+    bool is_open() const;
+    /// number of entries in the archive
+    int num_entries() const;
+    /// find an entry by file name, return -1 if not found
+    int find(const char* name) const;
+    /// get the file name of an entry
+    const char* name(int index) const;
+    /// get the uncompressed size of an entry
+    int size(int index) const;
+    /// get the content hash of an entry
+    uint32_t hash(int index) const;
+    /// get the filetype of an entry
+    filetype type(int index) const;
+    /// get the compatible systems of an entry
+    system compat(int index) const;
+    /// decompress an entry into a buffer of at least size(index) bytes, return false if failed
+    bool extract(int index, uint8_t* dst, int dst_size) const;
+
+private:
+    /// get a validated table of contents entry
+    const toc_entry& entry(int index) const;
+
+    const uint8_t* data = nullptr;
+    int data_size = 0;
+    const toc_entry* toc = nullptr;
+    int num = 0;
+};
+
+} // namespace YAKC
@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------------
+//  bootcache.cc
+//------------------------------------------------------------------------------
+#include "bootcache.h"
+#include "yakc/util/rom_images.h"
+#include <string.h>
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+bootcache::~bootcache() {
+    this->clear();
+}
+
+//------------------------------------------------------------------------------
+uint64_t
+bootcache::key(system model, os_rom os, const uint32_t* config, int num_config) {
+    YAKC_ASSERT(config && (num_config > 0));
+    uint32_t ids[2 + rom_images::max_required] = { uint32_t(model), uint32_t(os) };
+    rom_images::rom req[rom_images::max_required];
+    const int num_req = rom_images::required(model, os, req, rom_images::max_required);
+    for (int i = 0; i < num_req; i++) {
+        ids[2 + i] = roms.hash(req[i]);
+    }
+    const uint32_t rom_hash = rom_images::crc32((const uint8_t*)ids, sizeof(ids));
+    const uint32_t config_hash = rom_images::crc32((const uint8_t*)config, num_config * sizeof(uint32_t));
+    return (uint64_t(rom_hash)<<32) | config_hash;
+}
+
+//------------------------------------------------------------------------------
+const uint8_t*
+bootcache::find(uint64_t key, int state_size) const {
+    for (int i = 0; i < this->count; i++) {
+        const entry& e = this->entries[i];
+        if ((e.key == key) && (e.size == state_size)) {
+            return e.data;
+        }
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+void
+bootcache::add(uint64_t key, const void* state, int state_size) {
+    YAKC_ASSERT(state && (state_size > 0));
+    if (this->find(key, state_size)) {
+        return;
+    }
+    int index;
+    if (this->count < max_entries) {
+        index = this->count++;
+    }
+    else {
+        index = this->next;
+        this->next = (this->next + 1) % max_entries;
+    }
+    entry& e = this->entries[index];
+    if (e.data && (e.size != state_size)) {
+        YAKC_FREE(e.data);
+        e.data = nullptr;
+    }
+    if (!e.data) {
+        e.data = (uint8_t*) YAKC_MALLOC(state_size);
+    }
+    memcpy(e.data, state, state_size);
+    e.key = key;
+    e.size = state_size;
+}
+
+//------------------------------------------------------------------------------
+void
+bootcache::clear() {
+    for (int i = 0; i < max_entries; i++) {
+        entry& e = this->entries[i];
+        if (e.data) {
+            YAKC_FREE(e.data);
+        }
+        e = entry();
+    }
+    this->count = 0;
+    this->next = 0;
+}
+
+//------------------------------------------------------------------------------
+int
+bootcache::num_entries() const {
+    return this->count;
+}
+
+//------------------------------------------------------------------------------
+int
+bootcache::num_bytes() const {
+    int num = 0;
+    for (int i = 0; i < this->count; i++) {
+        num += this->entries[i].size;
+    }
+    return num;
+}
+
+} // namespace YAKC
@@ -0,0 +1,65 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::bootcache
+    @brief cache of machine states after the OS cold boot
+
+    After a poweron, the OS ROM of most systems needs an emulated second
+    or more for RAM tests and drawing the startup screen before the
+    machine is usable. With the boot cache enabled, the first boot of a
+    machine runs in real time as usual, and the machine state is stored
+    once the boot time has passed without any input. The next time the
+    same machine is switched on, this state is restored instead, so the
+    restored machine is ahead of a cold boot by the boot time (e.g. its
+    OS clocks).
+
+    Cache entries are keyed by pointer-free data only: the system model,
+    OS ROM, the content hashes of the required ROM images, and system
+    configuration data (e.g. the pre-boot memory content and inserted
+    expansion modules). The snapshots themselves contain host pointers
+    (ROM images, pixel buffer, callbacks), so the cache only lives in
+    memory, it is not persisted to disk.
+
+    The cache is disabled by default.
+*/
+#include "yakc/util/core.h"
+
+namespace YAKC {
+
+class bootcache {
+public:
+    /// max number of cached machine states
+    static const int max_entries = 16;
+
+    /// destructor
+    ~bootcache();
+    /// compute the cache key from pointer-free system configuration data
+    static uint64_t key(system model, os_rom os, const uint32_t* config, int num_config);
+    /// find a cached machine state, return nullptr if not cached
+    const uint8_t* find(uint64_t key, int state_size) const;
+    /// add a machine state (replaces the oldest entry if the cache is full)
+    void add(uint64_t key, const void* state, int state_size);
+    /// throw away all cached states
+    void clear();
+    /// number of cached states
+    int num_entries() const;
+    /// number of allocated bytes
+    int num_bytes() const;
+
+    /// restore cached states on poweron
+    bool enabled = false;
+    /// number of cache hits and misses (for statistics)
+    int hits = 0;
+    int misses = 0;
+
+private:
+    struct entry {
+        uint64_t key = 0;
+        uint8_t* data = nullptr;
+        int size = 0;
+    } entries[max_entries];
+    int count = 0;
+    int next = 0;       // entry to replace when the cache is full
+};
+
+} // namespace YAKC
@@ -5,10 +5,6 @@
 #include "breadboard.h"
 
 namespace YAKC {
-uint8_t breadboard::ram[breadboard::num_ram_banks][breadboard::ram_bank_size];
-uint8_t breadboard::random[breadboard::ram_bank_size];
-uint8_t breadboard::junk[breadboard::ram_bank_size];
-uint32_t breadboard::rgba8_buffer[global_max_fb_width*global_max_fb_height];
 breadboard board;
 
 void breadboard::clear() {
@@ -32,6 +28,38 @@ void breadboard::clear() {
     this->beeper_2 = nullptr;
     this->kbd = nullptr;
     this->crt = nullptr;
+    this->sys_state = nullptr;
+    this->sys_state_size = 0;
+    this->rgba8_buffer = nullptr;
+    this->rgba8_buffer_size = 0;
+    this->tickhook.reset();
+}
+
+//------------------------------------------------------------------------------
+void
+breadboard::select_rgba8_buffer(int width, int height) {
+    YAKC_ASSERT((width > 0) && (height > 0));
+    const int size = width * height * int(sizeof(uint32_t));
+    if (this->rgba8_alloc_size != size) {
+        // free the previous system's buffer first to keep the peak footprint low
+        this->free_rgba8_buffer();
+        this->rgba8_alloc = (uint32_t*) YAKC_MALLOC(size);
+        this->rgba8_alloc_size = size;
+        YAKC::clear(this->rgba8_alloc, size);
+    }
+    this->rgba8_buffer = this->rgba8_alloc;
+    this->rgba8_buffer_size = this->rgba8_alloc_size;
+}
+
+//------------------------------------------------------------------------------
+void
+breadboard::free_rgba8_buffer() {
+    YAKC_ASSERT(nullptr == this->rgba8_buffer);
+    if (this->rgba8_alloc) {
+        YAKC_FREE(this->rgba8_alloc);
+        this->rgba8_alloc = nullptr;
+        this->rgba8_alloc_size = 0;
+    }
 }
 
 } // namespace YAKC
@@ -7,6 +7,8 @@
 #include "yakc/util/core.h"
 #include "yakc/util/audiobuffer.h"
 #include "yakc/util/debugger.h"
+#include "yakc/util/tickhook.h"
+#include "yakc/util/profiler.h"
 #include "chips/clk.h"
 #include "chips/mem.h"
 #include "chips/kbd.h"
@@ -54,16 +56,28 @@ struct breadboard {
     beeper_t* beeper_2 = nullptr;
     kbd_t* kbd = nullptr;
     crt_t* crt = nullptr;
+    void* sys_state = nullptr;     // the system emulator state (for snapshots)
+    int sys_state_size = 0;
     class debugger dbg;
+    class tickhook tickhook;
+    class profiler profiler;
     int audio_sample_rate = 44100;
     class audiobuffer audiobuffer;
     class audiobuffer audiobuffer2;
-    static const int num_ram_banks = 8;
-    static const int ram_bank_size = 0x4000;
-    static uint8_t ram[num_ram_banks][ram_bank_size];
-    static uint8_t random[ram_bank_size];  // a 16-kbyte bank filled with random numbers
-    static uint8_t junk[ram_bank_size];    // a 16-kbyte page for junk writes
-    static uint32_t rgba8_buffer[global_max_fb_width*global_max_fb_height]; // RGBA8 linear pixel buffer
+    bool mute_audio = false;        // drop audio samples (e.g. during auto-warp)
+
+    /// select the RGBA8 pixel buffer for the current system, reallocated if the size changes
+    void select_rgba8_buffer(int width, int height);
+    /// free the pixel buffer (the system must be switched off)
+    void free_rgba8_buffer();
+    uint32_t* rgba8_buffer = nullptr;   // RGBA8 linear pixel buffer of the current system
+    int rgba8_buffer_size = 0;          // size of rgba8_buffer in bytes
+
+    // the pixel buffer allocation survives poweroff, and is only
+    // reallocated when a system with a different display size is
+    // switched on, since machine state snapshots point into it
+    uint32_t* rgba8_alloc = nullptr;
+    int rgba8_alloc_size = 0;
 };
 extern breadboard board;
 
@@ -0,0 +1,227 @@
+//------------------------------------------------------------------------------
+//  catalog.cc
+//------------------------------------------------------------------------------
+#include "catalog.h"
+#include <stdlib.h>
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+catalog::~catalog() {
+    this->clear();
+}
+
+//------------------------------------------------------------------------------
+void
+catalog::clear() {
+    if (this->text) {
+        YAKC_FREE(this->text);
+        this->text = nullptr;
+    }
+    if (this->entries) {
+        YAKC_FREE(this->entries);
+        this->entries = nullptr;
+    }
+    if (this->bucket_indices) {
+        YAKC_FREE(this->bucket_indices);
+        this->bucket_indices = nullptr;
+    }
+    this->num = 0;
+    for (int i = 0; i <= num_buckets; i++) {
+        this->bucket_start[i] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+char*
+catalog::next_field(char*& str) {
+    char* start = str;
+    char* sep = strchr(str, '|');
+    if (sep) {
+        *sep = 0;
+        str = sep + 1;
+    }
+    else {
+        str += strlen(str);
+    }
+    while ((*start == ' ') || (*start == '\t')) {
+        start++;
+    }
+    char* end = start + strlen(start);
+    while ((end > start) && ((end[-1] == ' ') || (end[-1] == '\t') || (end[-1] == '\r'))) {
+        *--end = 0;
+    }
+    return start;
+}
+
+//------------------------------------------------------------------------------
+bool
+catalog::parse_line(char* line, entry& out) {
+    out = entry();
+    out.name = next_field(line);
+    out.filename = next_field(line);
+    char* type = next_field(line);
+    char* systems = next_field(line);
+    char* options = next_field(line);
+    if (!out.name[0] || !out.filename[0]) {
+        return false;
+    }
+    out.type = filetype_from_string(type);
+    if (filetype::none == out.type) {
+        return false;
+    }
+    int compat = 0;
+    for (char* tok = strtok(systems, " \t,"); tok; tok = strtok(nullptr, " \t,")) {
+        const system sys = system_from_string(tok);
+        if (system::none == sys) {
+            return false;
+        }
+        compat |= int(sys);
+    }
+    if (0 == compat) {
+        return false;
+    }
+    out.compat = (system) compat;
+    for (char* tok = strtok(options, " \t"); tok; tok = strtok(nullptr, " \t")) {
+        if (0 == strcmp(tok, "joystick")) {
+            out.joystick = true;
+        }
+        else if (0 == strcmp(tok, "native")) {
+            out.native_only = true;
+        }
+        else if (0 == strncmp(tok, "start=", 6)) {
+            out.start_addr = (uint16_t) strtoul(tok + 6, nullptr, 16);
+        }
+        else if (0 == strncmp(tok, "exec=", 5)) {
+            out.exec_addr = (uint16_t) strtoul(tok + 5, nullptr, 16);
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+catalog::parse(const char* src, int size) {
+    YAKC_ASSERT(src && (size >= 0));
+    this->clear();
+
+    // copy the text so that it can be tokenized in place
+    this->text = (char*) YAKC_MALLOC(size + 1);
+    memcpy(this->text, src, size);
+    this->text[size] = 0;
+
+    // count lines for the upper bound of entries
+    int max_entries = 1;
+    for (int i = 0; i < size; i++) {
+        if ('\n' == this->text[i]) {
+            max_entries++;
+        }
+    }
+    this->entries = (entry*) YAKC_MALLOC(max_entries * sizeof(entry));
+
+    // parse lines, and count entries per bucket
+    bool ok = true;
+    int bucket_count[num_buckets] = { };
+    char* line = this->text;
+    while (line) {
+        char* next = strchr(line, '\n');
+        if (next) {
+            *next++ = 0;
+        }
+        while ((*line == ' ') || (*line == '\t')) {
+            line++;
+        }
+        if (line[0] && (line[0] != '#') && (line[0] != '\r')) {
+            entry& e = this->entries[this->num];
+            if (parse_line(line, e)) {
+                for (int b = 0; b < num_buckets; b++) {
+                    if (int(e.compat) & (1<<b)) {
+                        bucket_count[b]++;
+                    }
+                }
+                this->num++;
+            }
+            else {
+                ok = false;
+            }
+        }
+        line = next;
+    }
+
+    // build the bucket index
+    int total = 0;
+    for (int b = 0; b < num_buckets; b++) {
+        this->bucket_start[b] = total;
+        total += bucket_count[b];
+    }
+    this->bucket_start[num_buckets] = total;
+    this->bucket_indices = (int*) YAKC_MALLOC((total > 0 ? total : 1) * sizeof(int));
+    int fill[num_buckets];
+    for (int b = 0; b < num_buckets; b++) {
+        fill[b] = this->bucket_start[b];
+    }
+    for (int i = 0; i < this->num; i++) {
+        for (int b = 0; b < num_buckets; b++) {
+            if (int(this->entries[i].compat) & (1<<b)) {
+                this->bucket_indices[fill[b]++] = i;
+            }
+        }
+    }
+    return ok;
+}
+
+//------------------------------------------------------------------------------
+int
+catalog::num_entries() const {
+    return this->num;
+}
+
+//------------------------------------------------------------------------------
+const catalog::entry&
+catalog::at(int index) const {
+    YAKC_ASSERT((index >= 0) && (index < this->num));
+    return this->entries[index];
+}
+
+//------------------------------------------------------------------------------
+int
+catalog::find(const char* filename) const {
+    YAKC_ASSERT(filename);
+    for (int i = 0; i < this->num; i++) {
+        if (0 == strcmp(this->entries[i].filename, filename)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+int
+catalog::bucket(system model) {
+    const uint32_t bits = (uint32_t) model;
+    if ((0 == bits) || (0 != (bits & (bits - 1)))) {
+        return -1;
+    }
+    int b = 0;
+    while (0 == (bits & (1<<b))) {
+        b++;
+    }
+    return b;
+}
+
+//------------------------------------------------------------------------------
+int
+catalog::query(system model, const int*& out_indices) const {
+    const int b = bucket(model);
+    if ((b < 0) || !this->bucket_indices) {
+        out_indices = nullptr;
+        return 0;
+    }
+    out_indices = &this->bucket_indices[this->bucket_start[b]];
+    return this->bucket_start[b+1] - this->bucket_start[b];
+}
+
+} // namespace YAKC
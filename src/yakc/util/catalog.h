@@ -0,0 +1,75 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::catalog
+    @brief software catalog loaded from a text file
+
+    The catalog describes the quickloadable software titles, one title
+    per line, with the fields separated by '|':
+
+        name | filename | filetype | systems | options
+
+    The systems field is a space-separated list of system names
+    (see system_from_string()), the options field may contain 'joystick',
+    'native' (not available on the web platform), and 'start=XXXX' and
+    'exec=XXXX' with hex load and execution addresses. Lines starting
+    with '#' are comments.
+
+    The catalog text is copied and tokenized in place, and an index
+    with one bucket per system bit is built, so that all titles
+    compatible with a system can be looked up without iterating over
+    the whole catalog.
+*/
+#include "yakc/util/core.h"
+#include "yakc/util/filetypes.h"
+
+namespace YAKC {
+
+class catalog {
+public:
+    /// a catalog entry
+    struct entry {
+        const char* name = nullptr;
+        const char* filename = nullptr;
+        filetype type = filetype::none;
+        system compat = system::none;
+        uint16_t start_addr = 0;    // optional, 0 if not set
+        uint16_t exec_addr = 0;     // optional, 0 if not set
+        bool joystick = false;
+        bool native_only = false;
+    };
+    /// number of index buckets (one per system bit)
+    static const int num_buckets = 32;
+
+    /// destructor
+    ~catalog();
+    /// parse catalog text, replaces previous content, returns false if lines had to be skipped
+    bool parse(const char* text, int size);
+    /// free the catalog
+    void clear();
+    /// number of entries
+    int num_entries() const;
+    /// get entry by index
+    const entry& at(int index) const;
+    /// find entry by file name, return -1 if not found
+    int find(const char* filename) const;
+    /// get the entry indices compatible with a system, returns number of indices
+    int query(system model, const int*& out_indices) const;
+
+private:
+    /// parse a single line into an entry, return false if malformed
+    static bool parse_line(char* line, entry& out);
+    /// split off the next '|'-separated field and trim it
+    static char* next_field(char*& str);
+    /// get bucket index for a system with a single bit set, or -1
+    static int bucket(system model);
+
+    char* text = nullptr;
+    entry* entries = nullptr;
+    int num = 0;
+    // bucket b's entry indices are bucket_indices[bucket_start[b]..bucket_start[b+1]]
+    int bucket_start[num_buckets + 1] = { };
+    int* bucket_indices = nullptr;
+};
+
+} // namespace YAKC
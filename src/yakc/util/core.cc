@@ -2,6 +2,8 @@
 //  yakc/core.cc
 //------------------------------------------------------------------------------
 #include "core.h"
+#include <stdio.h>
+#include <stdlib.h>
 
 namespace YAKC {
 
@@ -32,6 +34,22 @@ fill_random(void* ptr, int num_bytes) {
     }
 }
 
+//------------------------------------------------------------------------------
+static void
+stderr_assertmsg(const char* cond, const char* msg, const char* file, int line, const char* func) {
+    fprintf(stderr, "assert: '%s' %s in %s, line %d (%s)\n", cond, msg ? msg : "", file, line, func);
+}
+
+//------------------------------------------------------------------------------
+ext_funcs
+default_ext_funcs() {
+    ext_funcs funcs;
+    funcs.assertmsg_func = stderr_assertmsg;
+    funcs.malloc_func = malloc;
+    funcs.free_func = free;
+    return funcs;
+}
+
 //------------------------------------------------------------------------------
 system
 system_from_string(const char* str) {
@@ -108,6 +126,28 @@ os_from_string(const char* str) {
     return os_rom::none;
 }
 
+//------------------------------------------------------------------------------
+const char*
+string_from_chip(chip::id c) {
+    switch (c) {
+        case chip::z80:         return "z80";
+        case chip::z80pio:      return "z80pio";
+        case chip::z80pio_2:    return "z80pio_2";
+        case chip::z80ctc:      return "z80ctc";
+        case chip::ay38910:     return "ay38910";
+        case chip::m6502:       return "m6502";
+        case chip::m6522:       return "m6522";
+        case chip::i8255:       return "i8255";
+        case chip::mc6847:      return "mc6847";
+        case chip::mc6845:      return "mc6845";
+        case chip::m6526:       return "m6526";
+        case chip::m6526_2:     return "m6526_2";
+        case chip::m6569:       return "m6569";
+        case chip::m6581:       return "m6581";
+        default:                return "none";
+    }
+}
+
 extern os_rom os_from_string(const char* str);
 
 } // namespace YAKC
@@ -43,6 +43,8 @@ extern struct ext_funcs func;
 extern void clear(void* ptr, int num_bytes);
 /// helper to fill a chunk of memory with random noise
 extern void fill_random(void* ptr, int num_bytes);
+/// get ext_funcs for headless tools (C runtime malloc/free, asserts printed to stderr)
+extern ext_funcs default_ext_funcs();
 
 #define YAKC_MALLOC(s) func.malloc_func(s)
 #define YAKC_FREE(p) func.free_func(p)
@@ -124,6 +126,7 @@ namespace chip {
 extern system system_from_string(const char* str);
 extern const char* string_from_system(system sys);
 extern os_rom os_from_string(const char* str);
+extern const char* string_from_chip(chip::id c);
 
 class joystick {
 public:
@@ -0,0 +1,372 @@
+//------------------------------------------------------------------------------
+//  coverage.cc
+//------------------------------------------------------------------------------
+#include "coverage.h"
+#include "yakc/util/breadboard.h"
+#include <string.h>
+#include <stdio.h>
+
+namespace YAKC {
+
+static const uint32_t save_magic = 0x564F4359;    // 'YCOV'
+static const uint32_t save_version = 1;
+
+//------------------------------------------------------------------------------
+coverage::~coverage() {
+    this->discard();
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::alloc_bits() {
+    if (!this->bits) {
+        this->bits = (recording*) YAKC_MALLOC(sizeof(recording));
+        memset(this->bits, 0, sizeof(recording));
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::enable() {
+    if (!this->enabled) {
+        this->alloc_bits();
+        this->enabled = board.tickhook.add(tick_observer, this);
+        if (this->enabled && !this->state_bits) {
+            this->attach();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::disable() {
+    if (this->enabled) {
+        board.tickhook.remove(tick_observer, this);
+        this->enabled = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::discard() {
+    this->disable();
+    if (this->state_bits) {
+        YAKC_FREE(this->state_bits);
+        this->state_bits = nullptr;
+    }
+    this->state_ptr = nullptr;
+    this->state_size = 0;
+    if (this->bits) {
+        YAKC_FREE(this->bits);
+        this->bits = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+coverage::is_enabled() const {
+    return this->enabled;
+}
+
+//------------------------------------------------------------------------------
+int
+coverage::num_bytes() const {
+    int num = this->bits ? int(sizeof(recording)) : 0;
+    if (this->state_bits) {
+        num += (this->state_size + 7) / 8;
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::clear() {
+    if (this->state_bits) {
+        memset(this->state_bits, 0, (this->state_size + 7) / 8);
+    }
+    if (this->bits) {
+        memset(this->bits, 0, sizeof(recording));
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::set_roms(const rom_images::rom* mapped_roms, int num_mapped_roms) {
+    YAKC_ASSERT(mapped_roms || (num_mapped_roms == 0));
+    YAKC_ASSERT((num_mapped_roms >= 0) && (num_mapped_roms <= max_mapped_roms));
+    for (int i = 0; i < num_mapped_roms; i++) {
+        this->mapped[i] = mapped_roms[i];
+    }
+    this->num_mapped = num_mapped_roms;
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::attach() {
+    this->detach();
+    if (board.sys_state) {
+        this->state_ptr = (const uint8_t*) board.sys_state;
+        this->state_size = board.sys_state_size;
+        const int num_bytes = (this->state_size + 7) / 8;
+        this->state_bits = (uint8_t*) YAKC_MALLOC(num_bytes);
+        memset(this->state_bits, 0, num_bytes);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::detach() {
+    if (this->state_bits) {
+        this->collect();
+        YAKC_FREE(this->state_bits);
+        this->state_bits = nullptr;
+    }
+    this->state_ptr = nullptr;
+    this->state_size = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::tick_observer(int /*num_ticks*/, uint64_t pins, void* user_data) {
+    if (board.z80) {
+        if ((pins & (Z80_M1|Z80_MREQ|Z80_RD)) == (Z80_M1|Z80_MREQ|Z80_RD)) {
+            ((coverage*)user_data)->record(pins & 0xFFFF);
+        }
+    }
+    else if (pins & M6502_SYNC) {
+        ((coverage*)user_data)->record(pins & 0xFFFF);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::record(uint16_t addr) {
+    this->bits->addr_bits[addr >> 3] |= 1 << (addr & 7);
+    const uint8_t* host_ptr = board.mem->page_table[addr >> MEM_PAGE_SHIFT].read_ptr + (addr & MEM_PAGE_MASK);
+    const uintptr_t offset = (uintptr_t)(host_ptr - this->state_ptr);
+    if (offset < (uintptr_t)this->state_size) {
+        this->state_bits[offset >> 3] |= 1 << (offset & 7);
+    }
+    else {
+        this->record_rom(host_ptr);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::record_rom(const uint8_t* host_ptr) {
+    for (int i = 0; i < this->num_mapped; i++) {
+        const rom_images::rom type = this->mapped[i];
+        if (roms.has(type)) {
+            const uintptr_t offset = (uintptr_t)(host_ptr - roms.ptr(type));
+            if ((offset < (uintptr_t)roms.size(type)) && (offset < (uintptr_t)max_rom_size)) {
+                this->bits->rom_bits[type][offset >> 3] |= 1 << (offset & 7);
+                return;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::collect() {
+    if (!this->state_bits || !this->bits) {
+        return;
+    }
+    // find the copy of each ROM image of the current system in the
+    // system state, and transfer the executed bits, a region which
+    // has been claimed by a ROM image isn't searched again
+    int claimed_pos[max_mapped_roms];
+    int claimed_size[max_mapped_roms];
+    int num_claimed = 0;
+    for (int i = 0; i < this->num_mapped; i++) {
+        const rom_images::rom type = this->mapped[i];
+        if (!roms.has(type)) {
+            continue;
+        }
+        const uint8_t* rom_ptr = roms.ptr(type);
+        const int rom_size = roms.size(type);
+        if ((rom_size > max_rom_size) || (rom_size > this->state_size)) {
+            continue;
+        }
+        for (int pos = 0; pos <= (this->state_size - rom_size); pos++) {
+            bool overlaps = false;
+            for (int c = 0; c < num_claimed; c++) {
+                if ((pos < (claimed_pos[c] + claimed_size[c])) && ((pos + rom_size) > claimed_pos[c])) {
+                    overlaps = true;
+                    break;
+                }
+            }
+            if (overlaps) {
+                continue;
+            }
+            if ((this->state_ptr[pos] == rom_ptr[0]) && (0 == memcmp(&this->state_ptr[pos], rom_ptr, rom_size))) {
+                for (int offset = 0; offset < rom_size; offset++) {
+                    const int bit = pos + offset;
+                    if (this->state_bits[bit >> 3] & (1 << (bit & 7))) {
+                        this->bits->rom_bits[type][offset >> 3] |= 1 << (offset & 7);
+                    }
+                }
+                claimed_pos[num_claimed] = pos;
+                claimed_size[num_claimed] = rom_size;
+                num_claimed++;
+                break;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+coverage::executed(rom_images::rom rom, int offset) const {
+    YAKC_ASSERT((rom >= 0) && (rom < rom_images::num_roms));
+    YAKC_ASSERT((offset >= 0) && (offset < max_rom_size));
+    return this->bits && (0 != (this->bits->rom_bits[rom][offset >> 3] & (1 << (offset & 7))));
+}
+
+//------------------------------------------------------------------------------
+bool
+coverage::executed(uint16_t addr) const {
+    return this->bits && (0 != (this->bits->addr_bits[addr >> 3] & (1 << (addr & 7))));
+}
+
+//------------------------------------------------------------------------------
+int
+coverage::num_executed(rom_images::rom rom) const {
+    int num = 0;
+    for (int offset = 0; offset < max_rom_size; offset++) {
+        if (this->executed(rom, offset)) {
+            num++;
+        }
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::merge(const coverage& other) {
+    if (!other.bits) {
+        return;
+    }
+    this->alloc_bits();
+    const uint8_t* src = (const uint8_t*) other.bits;
+    uint8_t* dst = (uint8_t*) this->bits;
+    for (int i = 0; i < int(sizeof(recording)); i++) {
+        dst[i] |= src[i];
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+coverage::save_size() {
+    return 4 * sizeof(uint32_t) + sizeof(recording);
+}
+
+//------------------------------------------------------------------------------
+void
+coverage::save(uint8_t* ptr) const {
+    YAKC_ASSERT(ptr);
+    const uint32_t hdr[4] = { save_magic, save_version, rom_images::num_roms, max_rom_size };
+    memcpy(ptr, hdr, sizeof(hdr)); ptr += sizeof(hdr);
+    if (this->bits) {
+        memcpy(ptr, this->bits->addr_bits, sizeof(this->bits->addr_bits)); ptr += sizeof(this->bits->addr_bits);
+        memcpy(ptr, this->bits->rom_bits, sizeof(this->bits->rom_bits));
+    }
+    else {
+        memset(ptr, 0, sizeof(recording));
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+coverage::load(const uint8_t* ptr, int size) {
+    YAKC_ASSERT(ptr);
+    if (size != save_size()) {
+        return false;
+    }
+    uint32_t hdr[4];
+    memcpy(hdr, ptr, sizeof(hdr)); ptr += sizeof(hdr);
+    if ((hdr[0] != save_magic) || (hdr[1] != save_version) ||
+        (hdr[2] != uint32_t(rom_images::num_roms)) || (hdr[3] != uint32_t(max_rom_size)))
+    {
+        return false;
+    }
+    this->alloc_bits();
+    for (int i = 0; i < int(sizeof(this->bits->addr_bits)); i++) {
+        this->bits->addr_bits[i] |= *ptr++;
+    }
+    for (int rom = 0; rom < rom_images::num_roms; rom++) {
+        for (int i = 0; i < (max_rom_size / 8); i++) {
+            this->bits->rom_bits[rom][i] |= *ptr++;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/// helper class to append formatted text to a fixed-size buffer, like snprintf
+struct lcov_writer {
+    char* buf;
+    int buf_size;
+    int pos = 0;
+
+    lcov_writer(char* b, int s) : buf(b), buf_size(s) { };
+    template<typename... ARGS> void print(const char* fmt, ARGS... args) {
+        char* dst = (buf && (pos < buf_size)) ? &buf[pos] : nullptr;
+        const int avail = dst ? (buf_size - pos) : 0;
+        pos += snprintf(dst, avail, fmt, args...);
+    }
+};
+
+//------------------------------------------------------------------------------
+int
+coverage::export_lcov(const char* test_name, char* buf, int buf_size) const {
+    lcov_writer w(buf, buf_size);
+    for (int i = 0; i < rom_images::num_roms; i++) {
+        const rom_images::rom rom = (rom_images::rom) i;
+        const int num_hit = this->num_executed(rom);
+        if ((num_hit == 0) || !roms.has(rom)) {
+            continue;
+        }
+        const int rom_size = roms.size(rom);
+        w.print("TN:%s\nSF:%s\n", test_name ? test_name : "", rom_images::name(rom));
+        for (int offset = 0; offset < rom_size; offset++) {
+            w.print("DA:%d,%d\n", offset + 1, this->executed(rom, offset) ? 1 : 0);
+        }
+        w.print("LF:%d\nLH:%d\nend_of_record\n", rom_size, num_hit);
+    }
+
+    // the CPU address space, only 256-byte pages with executed code
+    int num_found = 0;
+    int num_hit = 0;
+    for (int page = 0; page < 0x100; page++) {
+        bool any = false;
+        for (int i = 0; i < 32; i++) {
+            if (this->bits && this->bits->addr_bits[page*32 + i]) {
+                any = true;
+                break;
+            }
+        }
+        if (!any) {
+            continue;
+        }
+        if (num_found == 0) {
+            w.print("TN:%s\nSF:cpu\n", test_name ? test_name : "");
+        }
+        for (int addr = (page << 8); addr < ((page + 1) << 8); addr++) {
+            const bool hit = this->executed(uint16_t(addr));
+            w.print("DA:%d,%d\n", addr + 1, hit ? 1 : 0);
+            num_found++;
+            if (hit) {
+                num_hit++;
+            }
+        }
+    }
+    if (num_found > 0) {
+        w.print("LF:%d\nLH:%d\nend_of_record\n", num_found, num_hit);
+    }
+    // terminating zero
+    return w.pos + 1;
+}
+
+} // namespace YAKC
@@ -0,0 +1,105 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::coverage
+    @brief record executed instructions per ROM image and CPU address
+
+    While enabled, each opcode fetch sets a bit in a bitmap which covers
+    the system emulator state (where the ROM images are copied to), and
+    a bit in a bitmap of the 64 KByte CPU address space (for test
+    programs loaded into RAM). Going through the host memory pointer
+    means that bank-switched ROMs are recorded separately.
+
+    The host memory bits are attributed to the ROM images which the
+    current system can map (set with set_roms() at poweron) when
+    collect() is called, this happens automatically before the current
+    system is switched off. Each ROM image is located once in the system
+    state, ROMs which are mapped directly from the ROM image store are
+    recorded without going through the system state. ROM images of other
+    systems are never credited, even if they have identical content.
+
+    Recordings can be saved, loaded and merged, and exported as
+    lcov-style tracefile where each ROM byte offset is a 'line'.
+
+    The bitmaps are allocated on the first enable() (or load() or
+    merge()) and freed with discard().
+*/
+#include "yakc/util/core.h"
+#include "yakc/util/rom_images.h"
+
+namespace YAKC {
+
+class coverage {
+public:
+    /// max supported ROM image size
+    static const int max_rom_size = 0x4000;
+
+    /// destructor
+    ~coverage();
+    /// start recording
+    void enable();
+    /// stop recording (keeps recorded data)
+    void disable();
+    /// stop recording and free all recorded data
+    void discard();
+    /// return true if recording
+    bool is_enabled() const;
+    /// throw away all recorded data
+    void clear();
+    /// number of allocated bytes
+    int num_bytes() const;
+
+    /// max number of ROM images mapped by a system
+    static const int max_mapped_roms = 8;
+
+    /// set the ROM images which can be mapped by the current system
+    void set_roms(const rom_images::rom* mapped_roms, int num_mapped_roms);
+    /// attach to the current system after poweron
+    void attach();
+    /// attribute recorded bits to ROM images
+    void collect();
+    /// collect and detach from the current system before poweroff
+    void detach();
+
+    /// test if a ROM byte has been executed
+    bool executed(rom_images::rom rom, int offset) const;
+    /// test if a CPU address has been executed
+    bool executed(uint16_t addr) const;
+    /// get number of executed bytes in a ROM image
+    int num_executed(rom_images::rom rom) const;
+
+    /// merge another recording into this
+    void merge(const coverage& other);
+    /// size of serialized recording
+    static int save_size();
+    /// serialize recording into buffer of save_size()
+    void save(uint8_t* ptr) const;
+    /// merge a serialized recording, return false if invalid data
+    bool load(const uint8_t* ptr, int size);
+    /// write lcov-style tracefile, return required buffer size including terminating zero
+    int export_lcov(const char* test_name, char* buf, int buf_size) const;
+
+private:
+    /// tickhook observer, records opcode fetches
+    static void tick_observer(int num_ticks, uint64_t pins, void* user_data);
+    /// record an opcode fetch
+    void record(uint16_t addr);
+    /// allocate the recorded bits if not happened yet
+    void alloc_bits();
+    /// set a ROM bit if a host pointer is in a directly mapped ROM image
+    void record_rom(const uint8_t* host_ptr);
+
+    struct recording {
+        uint8_t addr_bits[0x10000 / 8];
+        uint8_t rom_bits[rom_images::num_roms][max_rom_size / 8];
+    };
+    bool enabled = false;
+    rom_images::rom mapped[max_mapped_roms];
+    int num_mapped = 0;
+    const uint8_t* state_ptr = nullptr;
+    int state_size = 0;
+    uint8_t* state_bits = nullptr;
+    recording* bits = nullptr;
+};
+
+} // namespace YAKC
@@ -0,0 +1,220 @@
+//------------------------------------------------------------------------------
+//  dsk.cc
+//------------------------------------------------------------------------------
+#include "dsk.h"
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+bool
+dsk::open(const uint8_t* ptr_, int size_) {
+    YAKC_ASSERT(ptr_);
+    this->close();
+    if (size_ < 256) {
+        return false;
+    }
+    if (0 == memcmp(ptr_, "EXTENDED", 8)) {
+        this->extended = true;
+    }
+    else if (0 == memcmp(ptr_, "MV - CPC", 8)) {
+        this->extended = false;
+    }
+    else {
+        return false;
+    }
+    const int num_tracks = ptr_[0x30];
+    const int num_sides = ptr_[0x31];
+    if ((num_tracks == 0) || (num_tracks > max_tracks) || (num_sides == 0) || (num_sides > max_sides)) {
+        return false;
+    }
+    this->ptr = ptr_;
+    this->size = size_;
+    this->tracks = num_tracks;
+    this->sides = num_sides;
+
+    // track info blocks follow the disc info block, in the extended
+    // format each track has its own size, and unformatted tracks
+    // have a size of 0
+    int offset = 256;
+    for (int t = 0; t < num_tracks; t++) {
+        for (int s = 0; s < num_sides; s++) {
+            const int trk_size = this->track_size(s, t);
+            if (0 == trk_size) {
+                continue;
+            }
+            if (((offset + trk_size) > size_) || !this->check_track(offset, trk_size)) {
+                this->close();
+                return false;
+            }
+            offset += trk_size;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+dsk::close() {
+    this->ptr = nullptr;
+    this->size = 0;
+    this->extended = false;
+    this->tracks = 0;
+    this->sides = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+dsk::is_open() const {
+    return nullptr != this->ptr;
+}
+
+//------------------------------------------------------------------------------
+int
+dsk::track_size(int side, int track_index) const {
+    if (this->extended) {
+        return this->ptr[0x34 + track_index * this->sides + side] * 256;
+    }
+    else {
+        return this->ptr[0x32] | (this->ptr[0x33]<<8);
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+dsk::sector_size(const uint8_t* info, const uint8_t* si) const {
+    if (this->extended) {
+        return si[6] | (si[7]<<8);
+    }
+    else {
+        // in the standard format, all sectors have the size from the track info
+        return 128 << (info[0x14] & 7);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+dsk::check_track(int offset, int trk_size) const {
+    const uint8_t* info = this->ptr + offset;
+    if ((trk_size < 256) || (0 != memcmp(info, "Track-Info", 10))) {
+        return false;
+    }
+    const int num_sectors = info[0x15];
+    if (num_sectors > max_sectors) {
+        return false;
+    }
+    int data_size = 256;
+    for (int i = 0; i < num_sectors; i++) {
+        data_size += this->sector_size(info, info + 0x18 + i * 8);
+    }
+    return data_size <= trk_size;
+}
+
+//------------------------------------------------------------------------------
+bool
+dsk::boot_cmd(char* buf, int buf_size) const {
+    YAKC_ASSERT(buf && (buf_size >= 16));
+    if (!this->is_open() || (0 == this->track_size(0, 0)) || (0 == this->ptr[256 + 0x15])) {
+        return false;
+    }
+    // AMSDOS data format discs have sector IDs C1..C9 and the directory
+    // on track 0, system format discs have sector IDs 41..49 and the
+    // directory on track 2 (after the CP/M boot tracks)
+    const uint8_t base = this->ptr[256 + 0x18 + 2] & 0xC0;
+    int dir_track = 0;
+    if (0xC0 == base) {
+        dir_track = 0;
+    }
+    else if (0x40 == base) {
+        dir_track = 2;
+    }
+    else {
+        return false;
+    }
+    if ((dir_track >= this->tracks) || (0 == this->track_size(0, dir_track))) {
+        return false;
+    }
+    // the tracks have been validated in open(), so the directory
+    // track starts after the sizes of all tracks before it
+    int offset = 256;
+    for (int i = 0; i < (dir_track * this->sides); i++) {
+        offset += this->track_size(i % this->sides, i / this->sides);
+    }
+    const uint8_t* info = this->ptr + offset;
+
+    // find the first BASIC program, or a binary if there's none;
+    // the directory has 64 entries of 32 bytes in 4 sectors
+    const uint8_t* best = nullptr;
+    int best_prio = 3;
+    for (int i = 0; i < 4; i++) {
+        const uint8_t* dir = nullptr;
+        int dir_size = 0;
+        const uint8_t* data = info + 256;
+        for (int s = 0; s < info[0x15]; s++) {
+            const uint8_t* si = info + 0x18 + s * 8;
+            const int sec_size = this->sector_size(info, si);
+            if (si[2] == (base + 1 + i)) {
+                dir = data;
+                dir_size = sec_size;
+                break;
+            }
+            data += sec_size;
+        }
+        if (!dir) {
+            return false;
+        }
+        for (int e = 0; (e + 1) * 32 <= dir_size; e++) {
+            const uint8_t* entry = dir + e * 32;
+            // only the first extent of files of user 0
+            if ((0 != entry[0]) || (0 != entry[12])) {
+                continue;
+            }
+            char ext[4] = { };
+            for (int j = 0; j < 3; j++) {
+                ext[j] = entry[9 + j] & 0x7F;
+            }
+            int prio = 3;
+            if (0 == strcmp(ext, "BAS")) {
+                prio = 0;
+            }
+            else if (0 == strcmp(ext, "   ")) {
+                prio = 1;
+            }
+            else if (0 == strcmp(ext, "BIN")) {
+                prio = 2;
+            }
+            if (prio < best_prio) {
+                best = entry;
+                best_prio = prio;
+            }
+        }
+    }
+    if (best) {
+        // run"name (AMSDOS tries the .BAS and .BIN extensions by itself)
+        int pos = 0;
+        buf[pos++] = 'r';
+        buf[pos++] = 'u';
+        buf[pos++] = 'n';
+        buf[pos++] = '"';
+        for (int j = 0; (j < 8) && (pos < (buf_size - 2)); j++) {
+            char c = best[1 + j] & 0x7F;
+            if (' ' == c) {
+                break;
+            }
+            if ((c >= 'A') && (c <= 'Z')) {
+                c = c - 'A' + 'a';
+            }
+            buf[pos++] = c;
+        }
+        buf[pos++] = '\n';
+        buf[pos] = 0;
+        return true;
+    }
+    else if (0x40 == base) {
+        // no files, boot CP/M
+        strcpy(buf, "|cpm\n");
+        return true;
+    }
+    return false;
+}
+
+} // namespace YAKC
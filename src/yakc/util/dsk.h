@@ -0,0 +1,53 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::dsk
+    @brief validate CPC disc images in standard and extended DSK format
+
+    The disc image is validated when opened, and the AMSDOS directory
+    is read to find the command which starts the disc. There is no
+    sector cache here, the sector data is read by the chips floppy
+    emulation, which decodes the image into its own track table when
+    the disc is inserted. The dsk object doesn't own the image data,
+    it must remain valid until the dsk is closed.
+
+    Format description: http://www.cpcwiki.eu/index.php/Format:DSK_disk_image_file_format
+*/
+#include "yakc/util/core.h"
+
+namespace YAKC {
+
+class dsk {
+public:
+    /// max number of tracks per side
+    static const int max_tracks = 84;
+    /// max number of sides
+    static const int max_sides = 2;
+    /// max number of sectors per track (limited by track info block size)
+    static const int max_sectors = 29;
+
+    /// open a DSK image (data must remain valid), return false if not valid
+    bool open(const uint8_t* ptr, int size);
+    /// close the image
+    void close();
+    /// return true if an image is open
+    bool is_open() const;
+    /// get the command to start the disc (e.g. run"name), return false if none found
+    bool boot_cmd(char* buf, int buf_size) const;
+
+private:
+    /// get the size of a track in the image (0 if unformatted)
+    int track_size(int side, int track_index) const;
+    /// check a track info block and its sector sizes, return false if not valid
+    bool check_track(int offset, int size) const;
+    /// get the size of a sector's data from its sector info
+    int sector_size(const uint8_t* track_info, const uint8_t* sector_info) const;
+
+    const uint8_t* ptr = nullptr;
+    int size = 0;
+    bool extended = false;
+    int tracks = 0;
+    int sides = 0;
+};
+
+} // namespace YAKC
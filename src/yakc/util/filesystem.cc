@@ -8,133 +8,264 @@
 
 namespace YAKC {
 
+//------------------------------------------------------------------------------
+void
+filesystem::init(int num_bytes) {
+    YAKC_ASSERT(num_bytes > 0);
+    this->discard();
+    this->store = (uint8_t*) YAKC_MALLOC(num_bytes);
+    this->size_of_store = num_bytes;
+    this->reset();
+}
+
+//------------------------------------------------------------------------------
+void
+filesystem::discard() {
+    this->reset();
+    if (this->store) {
+        YAKC_FREE(this->store);
+        this->store = nullptr;
+    }
+    this->size_of_store = 0;
+    this->num_free_extents = 0;
+}
+
 //------------------------------------------------------------------------------
 void
 filesystem::reset() {
+    for (file f = 1; f < max_num_files; f++) {
+        if (files[f].valid && (files[f].mode == ownership::take)) {
+            YAKC_FREE((void*)files[f].ptr);
+        }
+    }
     for (auto& f : files) {
         f = file_item();
     }
-    free_pos = 0;
-    clear(store, sizeof(store));
+    for (auto& i : index) {
+        i = 0;
+    }
+    this->num_free_extents = 0;
+    if (this->size_of_store > 0) {
+        this->free_list[0].pos = 0;
+        this->free_list[0].size = this->size_of_store;
+        this->num_free_extents = 1;
+    }
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+filesystem::hash(const char* name) {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (int i = 0; name[i] && (i < file_item::max_name_size-1); i++) {
+        h = (h ^ uint8_t(name[i])) * 16777619u;
+    }
+    return h;
+}
+
+//------------------------------------------------------------------------------
+void
+filesystem::insert_index(file f) {
+    uint32_t slot = files[f].hash & (hash_size-1);
+    while (index[slot] != 0) {
+        slot = (slot + 1) & (hash_size-1);
+    }
+    index[slot] = f;
+}
+
+//------------------------------------------------------------------------------
+void
+filesystem::remove_index(file f) {
+    uint32_t slot = files[f].hash & (hash_size-1);
+    while ((index[slot] != 0) && (index[slot] != f)) {
+        slot = (slot + 1) & (hash_size-1);
+    }
+    if (index[slot] == 0) {
+        return;
+    }
+    // backward-shift deletion: move following entries of the probe
+    // sequence into the hole unless their home slot lies between the
+    // hole and their current slot, so that no tombstones are needed
+    uint32_t hole = slot;
+    uint32_t next = (hole + 1) & (hash_size-1);
+    while (index[next] != 0) {
+        const uint32_t home = files[index[next]].hash & (hash_size-1);
+        const uint32_t dist_home = (next - home) & (hash_size-1);
+        const uint32_t dist_hole = (next - hole) & (hash_size-1);
+        if (dist_home >= dist_hole) {
+            index[hole] = index[next];
+            hole = next;
+        }
+        next = (next + 1) & (hash_size-1);
+    }
+    index[hole] = 0;
 }
 
 //------------------------------------------------------------------------------
 filesystem::file
-filesystem::find(const char* name) {
+filesystem::find(const char* name) const {
     YAKC_ASSERT(name);
-    for (int i = 0; i < max_num_files; i++) {
-        if (files[i].valid) {
-            if (strncmp(name, files[i].name, sizeof(files[i].name)) == 0) {
-                return i;
+    const uint32_t h = hash(name);
+    uint32_t slot = h & (hash_size-1);
+    for (int i = 0; (i < hash_size) && (index[slot] != 0); i++) {
+        const file f = index[slot];
+        if (files[f].hash == h) {
+            if (strncmp(name, files[f].name, sizeof(files[f].name)-1) == 0) {
+                return f;
             }
         }
+        slot = (slot + 1) & (hash_size-1);
     }
     return invalid_file;
 }
 
 //------------------------------------------------------------------------------
 bool
-filesystem::exists(const char* name) {
+filesystem::exists(const char* name) const {
     YAKC_ASSERT(name);
     return 0 != find(name);
 }
 
 //------------------------------------------------------------------------------
 int
-filesystem::alloc_store(const void* ptr, int num_bytes) {
-    if ((free_pos + num_bytes) > store_size) {
-        return -1;
+filesystem::alloc_store(int num_bytes) {
+    // first fit
+    for (int i = 0; i < num_free_extents; i++) {
+        extent& ext = free_list[i];
+        if (ext.size >= num_bytes) {
+            const int pos = ext.pos;
+            ext.pos += num_bytes;
+            ext.size -= num_bytes;
+            if (0 == ext.size) {
+                for (int j = i; j < (num_free_extents - 1); j++) {
+                    free_list[j] = free_list[j+1];
+                }
+                num_free_extents--;
+            }
+            return pos;
+        }
     }
-    int pos = this->free_pos;
-    free_pos += num_bytes;
-    memcpy(&store[pos], ptr, num_bytes);
-    return pos;
+    return -1;
 }
 
 //------------------------------------------------------------------------------
-bool
-filesystem::free_store(file f) {
-    YAKC_ASSERT((f >= 0) && (f < max_num_files));
-    if (!files[f].valid) {
-        return false;
-    }
-    int pos = files[f].pos;
-    int size = files[f].size;
-    YAKC_ASSERT((pos + size) <= free_pos);
-    YAKC_ASSERT(free_pos >= size);
-    for (file_item& item : files) {
-        if (item.valid) {
-            if (item.pos > pos) {
-                item.pos -= size;
-                YAKC_ASSERT(item.pos >= 0);
-            }
+void
+filesystem::free_store(int pos, int num_bytes) {
+    YAKC_ASSERT((pos >= 0) && ((pos + num_bytes) <= size_of_store));
+    // find insertion point, free list is sorted by position
+    int i = 0;
+    while ((i < num_free_extents) && (free_list[i].pos < pos)) {
+        i++;
+    }
+    const bool merge_prev = (i > 0) && ((free_list[i-1].pos + free_list[i-1].size) == pos);
+    const bool merge_next = (i < num_free_extents) && ((pos + num_bytes) == free_list[i].pos);
+    if (merge_prev && merge_next) {
+        free_list[i-1].size += num_bytes + free_list[i].size;
+        for (int j = i; j < (num_free_extents - 1); j++) {
+            free_list[j] = free_list[j+1];
         }
+        num_free_extents--;
     }
-    const int bytes_to_move = free_pos - (pos + size);
-    if (bytes_to_move > 0) {
-        memmove(&store[pos], &store[pos+size], bytes_to_move);
+    else if (merge_prev) {
+        free_list[i-1].size += num_bytes;
+    }
+    else if (merge_next) {
+        free_list[i].pos = pos;
+        free_list[i].size += num_bytes;
+    }
+    else {
+        YAKC_ASSERT(num_free_extents < max_extents);
+        for (int j = num_free_extents; j > i; j--) {
+            free_list[j] = free_list[j-1];
+        }
+        free_list[i].pos = pos;
+        free_list[i].size = num_bytes;
+        num_free_extents++;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+filesystem::rm(file f) {
+    YAKC_ASSERT((f >= 0) && (f < max_num_files));
+    if (f && files[f].valid) {
+        switch (files[f].mode) {
+            case ownership::copy:
+                free_store(files[f].pos, files[f].size);
+                break;
+            case ownership::take:
+                YAKC_FREE((void*)files[f].ptr);
+                break;
+            case ownership::borrow:
+                break;
+        }
+        remove_index(f);
+        files[f] = file_item();
     }
-    free_pos -= size;
-    return true;
 }
 
 //------------------------------------------------------------------------------
 void
 filesystem::rm(const char* name) {
     YAKC_ASSERT(name);
-    file h = find(name);
-    if (h) {
-        free_store(h);
-        files[h] = file_item();
-    }
+    rm(find(name));
 }
 
 //------------------------------------------------------------------------------
-bool
-filesystem::add(const char* name, const void* ptr, int num_bytes) {
+filesystem::file
+filesystem::add(const char* name, const void* ptr, int num_bytes, ownership mode) {
     YAKC_ASSERT(name && ptr && (num_bytes > 0));
     // file already exists?
     if (find(name)) {
         return invalid_file;
     }
     // find first free file handle
-    file h = invalid_file;
+    file h;
     for (h = 1; h < max_num_files; h++) {
         if (!files[h].valid) {
             break;
         }
     }
     // no free file handle found?
-    if (!h) {
-        return false;
+    if (h == max_num_files) {
+        return invalid_file;
     }
 
     // allocate and copy data
-    int pos = alloc_store(ptr, num_bytes);
-    if (pos < 0) {
-        // not enough space in storage left
-        return false;
+    file_item& item = files[h];
+    if (ownership::copy == mode) {
+        int pos = alloc_store(num_bytes);
+        if (pos < 0) {
+            // not enough space in storage left
+            return invalid_file;
+        }
+        memcpy(&store[pos], ptr, num_bytes);
+        item.pos = pos;
+        item.ptr = &store[pos];
+    }
+    else {
+        item.ptr = (const uint8_t*) ptr;
     }
 
     // initialize new file item
-    file_item& item = files[h];
     strncpy(item.name, name, sizeof(item.name));
     item.name[sizeof(item.name)-1] = 0;
+    item.hash = hash(item.name);
     item.valid = true;
-    item.pos = pos;
+    item.mode = mode;
     item.size = num_bytes;
+    insert_index(h);
 
-    return h != invalid_file;
+    return h;
 }
 
 //------------------------------------------------------------------------------
 const void*
-filesystem::get(const char* name, int& out_size) {
-    YAKC_ASSERT(name);
-    file h = find(name);
-    if (h) {
-        out_size = files[h].size;
-        return &store[files[h].pos];
+filesystem::get(file f, int& out_size) const {
+    YAKC_ASSERT((f >= 0) && (f < max_num_files));
+    if (f && files[f].valid) {
+        out_size = files[f].size;
+        return files[f].ptr;
     }
     else {
         out_size = 0;
@@ -142,5 +273,27 @@ filesystem::get(const char* name, int& out_size) {
     }
 }
 
-} // namespace YAKC
+//------------------------------------------------------------------------------
+const void*
+filesystem::get(const char* name, int& out_size) const {
+    YAKC_ASSERT(name);
+    return get(find(name), out_size);
+}
+
+//------------------------------------------------------------------------------
+int
+filesystem::store_size() const {
+    return this->size_of_store;
+}
 
+//------------------------------------------------------------------------------
+int
+filesystem::free_bytes() const {
+    int num = 0;
+    for (int i = 0; i < num_free_extents; i++) {
+        num += free_list[i].size;
+    }
+    return num;
+}
+
+} // namespace YAKC
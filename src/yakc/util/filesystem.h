@@ -5,6 +5,14 @@
     
     A simple memory filesystem for transferring files between 
     emulated systems and the outside world.
+
+    File names are looked up through a hash index (linear probing,
+    removed entries are closed by backward-shift deletion). File data either
+    lives in the byte store (which is allocated once in init() with
+    a configurable size and managed with a free-list, so that files
+    are never moved around), or in an external buffer which is either
+    owned by the filesystem (freed with YAKC_FREE when the file is
+    removed), or borrowed (must remain valid until the file is removed).
 */
 #include "yakc/util/core.h"
 
@@ -16,46 +24,82 @@ public:
     typedef int file;
     /// the invalid file handle (must evaluate to false!)
     static const int invalid_file = 0;
+    /// how add() treats the file data
+    enum class ownership {
+        copy,       // copy data into the byte store
+        take,       // take ownership of a buffer allocated with YAKC_MALLOC
+        borrow,     // reference data, caller keeps it alive until file is removed
+    };
+    /// default byte store size
+    static const int default_store_size = 1024 * 1024;
+    /// max number of files
+    static const int max_num_files = 64;
 
+    /// allocate the byte store
+    void init(int store_size=default_store_size);
+    /// free the byte store and all owned files
+    void discard();
     /// clear everything in the filesystem
     void reset();
-    /// add a file
-    bool add(const char* name, const void* ptr, int num_bytes);
-    /// get pointer and size of file
-    const void* get(const char* name, int& out_size);
-    /// delete a file
+    /// add a file, returns invalid_file if name exists or out of space
+    file add(const char* name, const void* ptr, int num_bytes, ownership mode=ownership::copy);
+    /// get pointer and size of file by name
+    const void* get(const char* name, int& out_size) const;
+    /// get pointer and size of file by handle
+    const void* get(file f, int& out_size) const;
+    /// delete a file by name
     void rm(const char* name);
+    /// delete a file by handle
+    void rm(file f);
     /// test if a file exists
-    bool exists(const char* name);
+    bool exists(const char* name) const;
     /// find a file entry by name
-    file find(const char* name);
-
-    static const int store_size = (1024 * 1024);
-    static const int max_num_files = 16;
+    file find(const char* name) const;
+    /// get size of byte store
+    int store_size() const;
+    /// get number of free bytes in byte store
+    int free_bytes() const;
 
+private:
     struct file_item {
         static const int max_name_size = 128;
         char name[max_name_size] = { };
+        uint32_t hash = 0;
         bool valid = false;
+        ownership mode = ownership::copy;
+        const uint8_t* ptr = nullptr;
+        int pos = 0;
+        int size = 0;
+    };
+    /// a free region in the byte store
+    struct extent {
         int pos = 0;
         int size = 0;
     };
+    static const int hash_size = 2 * max_num_files;     // must be 2^N
+    static const int max_extents = max_num_files + 1;
 
-    /// current top-free pos
-    int free_pos = 0;
+    /// compute the hash of a file name
+    static uint32_t hash(const char* name);
+    /// insert a file handle into the hash index
+    void insert_index(file f);
+    /// remove a file handle from the hash index
+    void remove_index(file f);
+    /// allocate storage space, returns pos-index or -1 if no free space
+    int alloc_store(int num_bytes);
+    /// free storage space, coalesces with neighbouring free regions
+    void free_store(int pos, int num_bytes);
 
     /// note the first entry is never used (it's the 'invalid file')
     file_item files[max_num_files];
+    /// hash index, file handles with 0 as empty slot
+    int index[hash_size] = { };
+    /// free regions in the byte store, sorted by position
+    extent free_list[max_extents];
+    int num_free_extents = 0;
     /// byte store
-    uint8_t store[store_size];
-
-    /// allocate storage space, returns pos-index, updates free_pos, return -1 if no free space
-    int alloc_store(const void* ptr, int num_bytes);
-    /// free storage space for file item, merges holes, updates file items
-    bool free_store(file f);
+    uint8_t* store = nullptr;
+    int size_of_store = 0;
 };
 
 } // namespace YAKC
-
-
-
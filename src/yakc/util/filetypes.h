@@ -17,6 +17,7 @@ enum class filetype {
     cpc_sna,
     cpc_tap,
     cpc_bin,    // raw bin file with 128 byte AMSDOS header (http://www.cpcwiki.eu/index.php/AMSDOS_Header)
+    cpc_dsk,    // standard or extended DSK disc image
     atom_tap,
     c64_tap,
     text,
@@ -36,6 +37,7 @@ inline filetype filetype_from_string(const char* str) {
     if (strcmp(str, "cpc_sna")==0) return filetype::cpc_sna;
     if (strcmp(str, "cpc_tap")==0) return filetype::cpc_tap;
     if (strcmp(str, "cpc_bin")==0) return filetype::cpc_bin;
+    if (strcmp(str, "cpc_dsk")==0) return filetype::cpc_dsk;
     if (strcmp(str, "atom_tap")==0) return filetype::atom_tap;
     if (strcmp(str, "c64_tap")==0) return filetype::c64_tap;
     if (strcmp(str, "text")==0) return filetype::text;
@@ -48,6 +50,7 @@ inline bool filetype_quickloadable(filetype t) {
         case filetype::cpc_tap:
         case filetype::atom_tap:
         case filetype::c64_tap:
+        case filetype::zx_tap:
             return false;
         default:
             return true;
@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+//  fork_state.cc
+//------------------------------------------------------------------------------
+#include "fork_state.h"
+#include <string.h>
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+fork_state::~fork_state() {
+    this->clear();
+}
+
+//------------------------------------------------------------------------------
+fork_state::fork_state(const fork_state& rhs) {
+    this->share(rhs);
+}
+
+//------------------------------------------------------------------------------
+fork_state::fork_state(fork_state&& rhs) {
+    this->pages = rhs.pages;
+    this->num_pages = rhs.num_pages;
+    this->state_size = rhs.state_size;
+    rhs.pages = nullptr;
+    rhs.num_pages = 0;
+    rhs.state_size = 0;
+}
+
+//------------------------------------------------------------------------------
+fork_state&
+fork_state::operator=(const fork_state& rhs) {
+    if (this != &rhs) {
+        this->clear();
+        this->share(rhs);
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+fork_state&
+fork_state::operator=(fork_state&& rhs) {
+    if (this != &rhs) {
+        this->clear();
+        this->pages = rhs.pages;
+        this->num_pages = rhs.num_pages;
+        this->state_size = rhs.state_size;
+        rhs.pages = nullptr;
+        rhs.num_pages = 0;
+        rhs.state_size = 0;
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+void
+fork_state::share(const fork_state& rhs) {
+    YAKC_ASSERT(nullptr == this->pages);
+    if (rhs.pages) {
+        this->num_pages = rhs.num_pages;
+        this->state_size = rhs.state_size;
+        this->pages = (page**) YAKC_MALLOC(this->num_pages * sizeof(page*));
+        for (int i = 0; i < this->num_pages; i++) {
+            this->pages[i] = rhs.pages[i];
+            this->pages[i]->refs++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+fork_state::release(page* p) {
+    if (p && (0 == --p->refs)) {
+        YAKC_FREE(p);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+fork_state::clear() {
+    if (this->pages) {
+        for (int i = 0; i < this->num_pages; i++) {
+            release(this->pages[i]);
+        }
+        YAKC_FREE(this->pages);
+        this->pages = nullptr;
+    }
+    this->num_pages = 0;
+    this->state_size = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+fork_state::empty() const {
+    return nullptr == this->pages;
+}
+
+//------------------------------------------------------------------------------
+int
+fork_state::size() const {
+    return this->state_size;
+}
+
+//------------------------------------------------------------------------------
+int
+fork_state::num_owned_pages() const {
+    int num = 0;
+    for (int i = 0; i < this->num_pages; i++) {
+        if (1 == this->pages[i]->refs) {
+            num++;
+        }
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+void
+fork_state::save(const uint8_t* ptr, int size) {
+    YAKC_ASSERT(ptr && (size > 0));
+    if (size != this->state_size) {
+        this->clear();
+        this->num_pages = (size + page_size - 1) / page_size;
+        this->state_size = size;
+        this->pages = (page**) YAKC_MALLOC(this->num_pages * sizeof(page*));
+        memset(this->pages, 0, this->num_pages * sizeof(page*));
+    }
+    for (int i = 0; i < this->num_pages; i++) {
+        const int offset = i * page_size;
+        const int num_bytes = ((size - offset) < page_size) ? (size - offset) : page_size;
+        page* p = this->pages[i];
+        if (p && (0 == memcmp(p->data, ptr + offset, num_bytes))) {
+            continue;
+        }
+        if (!p || (p->refs > 1)) {
+            // page is shared with other forks, make a private copy
+            release(p);
+            p = (page*) YAKC_MALLOC(sizeof(page));
+            p->refs = 1;
+            this->pages[i] = p;
+        }
+        memcpy(p->data, ptr + offset, num_bytes);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+fork_state::restore(uint8_t* ptr) const {
+    YAKC_ASSERT(ptr && this->pages);
+    for (int i = 0; i < this->num_pages; i++) {
+        const int offset = i * page_size;
+        const int num_bytes = ((this->state_size - offset) < page_size) ? (this->state_size - offset) : page_size;
+        memcpy(ptr + offset, this->pages[i]->data, num_bytes);
+    }
+}
+
+} // namespace YAKC
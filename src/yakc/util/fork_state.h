@@ -0,0 +1,72 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::fork_state
+    @brief a machine state snapshot which shares pages with its forks
+
+    The machine state is split into pages of the same size as the memory
+    pages of the system emulators. Copying a fork_state is cheap, since
+    the copy only references the pages of the original. When a state is
+    saved into a fork_state, only pages which actually changed are
+    written, and pages which are still shared with other forks are
+    copied first (copy-on-write).
+
+    This way, many forks of the same machine state (e.g. for trying out
+    different input sequences) only need memory for the pages where
+    they diverge. Forks are created and run through yakc::fork(),
+    yakc::load_fork() and yakc::save_fork().
+
+    NOTE: the page reference counts are not thread-safe, and only the
+    state of the system emulator is forked (not tape or paste state).
+*/
+#include "yakc/util/core.h"
+
+namespace YAKC {
+
+class fork_state {
+public:
+    /// page size, same as the chips mem_t page size
+    static const int page_size = 1024;
+
+    /// default constructor
+    fork_state() { };
+    /// destructor, releases page references
+    ~fork_state();
+    /// copy constructor, shares all pages
+    fork_state(const fork_state& rhs);
+    /// move constructor
+    fork_state(fork_state&& rhs);
+    /// copy-assignment, shares all pages
+    fork_state& operator=(const fork_state& rhs);
+    /// move-assignment
+    fork_state& operator=(fork_state&& rhs);
+
+    /// write a machine state, copies only changed pages
+    void save(const uint8_t* ptr, int size);
+    /// restore the machine state into a buffer of size()
+    void restore(uint8_t* ptr) const;
+    /// release all pages
+    void clear();
+    /// return true if a state has been saved
+    bool empty() const;
+    /// size of the machine state in bytes
+    int size() const;
+    /// number of pages which are not shared with other forks
+    int num_owned_pages() const;
+
+private:
+    struct page {
+        int refs;
+        uint8_t data[page_size];
+    };
+    /// share the pages of another fork_state
+    void share(const fork_state& rhs);
+    /// drop a page reference, free the page when unreferenced
+    static void release(page* p);
+
+    page** pages = nullptr;
+    int num_pages = 0;
+    int state_size = 0;
+};
+
+} // namespace YAKC
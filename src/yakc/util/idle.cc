@@ -0,0 +1,182 @@
+//------------------------------------------------------------------------------
+//  idle.cc
+//------------------------------------------------------------------------------
+#include "idle.h"
+#include "yakc/util/breadboard.h"
+#include <string.h>
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+static inline uint64_t
+mix(uint16_t addr, uint8_t data) {
+    // splitmix64 finalizer
+    uint64_t x = (uint64_t(addr)<<8) | data;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+//------------------------------------------------------------------------------
+idle::~idle() {
+    this->disable();
+}
+
+//------------------------------------------------------------------------------
+void
+idle::enable() {
+    if (!this->enabled) {
+        this->mem = (tracking*) YAKC_MALLOC(sizeof(tracking));
+        memset(this->mem, 0, sizeof(tracking));
+        this->apply_excludes();
+        this->hash = 0;
+        this->enabled = board.tickhook.add(tick_observer, this);
+        if (!this->enabled) {
+            YAKC_FREE(this->mem);
+            this->mem = nullptr;
+        }
+        this->wake();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+idle::disable() {
+    if (this->enabled) {
+        board.tickhook.remove(tick_observer, this);
+        this->enabled = false;
+        this->wake();
+    }
+    if (this->mem) {
+        YAKC_FREE(this->mem);
+        this->mem = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+idle::is_enabled() const {
+    return this->enabled;
+}
+
+//------------------------------------------------------------------------------
+int
+idle::num_bytes() const {
+    return this->mem ? int(sizeof(tracking)) : 0;
+}
+
+//------------------------------------------------------------------------------
+void
+idle::exclude(uint16_t addr, int num_bytes) {
+    YAKC_ASSERT(this->num_excludes < max_excludes);
+    range& r = this->excludes[this->num_excludes++];
+    r.addr = addr;
+    r.num_bytes = num_bytes;
+    this->apply_excludes();
+}
+
+//------------------------------------------------------------------------------
+void
+idle::clear_excludes() {
+    this->num_excludes = 0;
+    this->apply_excludes();
+}
+
+//------------------------------------------------------------------------------
+void
+idle::apply_excludes() {
+    if (!this->mem) {
+        return;
+    }
+    memset(this->mem->excluded, 0, sizeof(this->mem->excluded));
+    for (int r = 0; r < this->num_excludes; r++) {
+        for (int i = 0; i < this->excludes[r].num_bytes; i++) {
+            const uint16_t a = this->excludes[r].addr + i;
+            this->mem->excluded[a>>3] |= 1<<(a & 7);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+idle::wake() {
+    this->history_pos = 0;
+    this->history_count = 0;
+    this->repeat_count = 0;
+    this->skipped_us = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+idle::on_frame() {
+    if (!this->enabled) {
+        return;
+    }
+    bool repeating = false;
+    for (int i = 0; i < this->history_count; i++) {
+        if (this->history[i] == this->hash) {
+            repeating = true;
+            break;
+        }
+    }
+    this->history[this->history_pos] = this->hash;
+    this->history_pos = (this->history_pos + 1) % history_size;
+    if (this->history_count < history_size) {
+        this->history_count++;
+    }
+    if (repeating) {
+        if (this->repeat_count < this->idle_frames) {
+            this->repeat_count++;
+        }
+    }
+    else {
+        this->repeat_count = 0;
+    }
+    // a halted Z80 with interrupts disabled will never continue
+    if (board.z80 && (this->last_pins & Z80_HALT) && !z80_iff1(board.z80)) {
+        this->repeat_count = this->idle_frames;
+    }
+    this->skipped_us = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+idle::can_skip() const {
+    return this->enabled && (this->repeat_count >= this->idle_frames) && (this->skipped_us < this->max_skip_us);
+}
+
+//------------------------------------------------------------------------------
+void
+idle::on_skip(int micro_secs) {
+    this->skipped_us += micro_secs;
+    this->skipped_frames++;
+}
+
+//------------------------------------------------------------------------------
+inline void
+idle::write(uint16_t addr, uint8_t data) {
+    if (0 == (this->mem->excluded[addr>>3] & (1<<(addr & 7)))) {
+        const uint8_t old = this->mem->shadow[addr];
+        if (old != data) {
+            this->hash += mix(addr, data) - mix(addr, old);
+            this->mem->shadow[addr] = data;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+idle::tick_observer(int /*num_ticks*/, uint64_t pins, void* user_data) {
+    idle* self = (idle*) user_data;
+    self->last_pins = pins;
+    if (board.z80) {
+        if ((pins & (Z80_MREQ|Z80_WR)) == (Z80_MREQ|Z80_WR)) {
+            self->write(Z80_GET_ADDR(pins), Z80_GET_DATA(pins));
+        }
+    }
+    else if (0 == (pins & M6502_RW)) {
+        self->write(M6502_GET_ADDR(pins), M6502_GET_DATA(pins));
+    }
+}
+
+} // namespace YAKC
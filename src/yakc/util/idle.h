@@ -0,0 +1,105 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::idle
+    @brief detect when the emulated system is idle
+
+    A system is considered idle when the content of memory written by the
+    CPU only cycles through states it has already been in during the last
+    'history_size' frames (for instance a keyboard polling loop with a
+    blinking cursor), for at least 'idle_frames' frames. A Z80 in HALT
+    with interrupts disabled is idle immediately. A Z80 in HALT with
+    interrupts enabled (the common EI; HALT wait loop) is woken by each
+    interrupt, and is detected like any other loop when its interrupt
+    handler only writes repeating or excluded memory.
+
+    Memory writes are observed through the tickhook and folded into an
+    order-independent hash of the written memory content. RAM timers
+    which are updated by interrupt handlers even on idle systems (like
+    the C64 jiffy clock) must be excluded, and are advanced by the system
+    emulators instead while frames are skipped.
+
+    While idle, yakc::exec() skips frames, but still emulates one frame
+    every 'max_skip_us' so that programs which wait for a timer
+    continue. Any input wakes the system up. Only systems which can
+    advance their OS clocks in RAM skip frames (currently the C64 and
+    ZX Spectrum), the skipped time is filled with audio samples, but
+    the chips aren't advanced: the video output shows the last frame,
+    and periodic hardware timers continue with a different phase.
+    Frames are never skipped while the tape motor is on.
+
+    The detection is only hooked into the CPU tick callback while
+    enabled, so there's no overhead when idle skipping is disabled,
+    the shadow copy of the written memory is allocated in enable()
+    and freed in disable().
+*/
+#include "yakc/util/core.h"
+
+namespace YAKC {
+
+class idle {
+public:
+    /// number of frame hashes to check for repeating states
+    static const int history_size = 64;
+    /// max number of excluded memory ranges
+    static const int max_excludes = 4;
+
+    /// destructor
+    ~idle();
+    /// start idle detection
+    void enable();
+    /// stop idle detection
+    void disable();
+    /// return true if enabled
+    bool is_enabled() const;
+    /// number of allocated bytes
+    int num_bytes() const;
+    /// exclude a memory range from idle detection (e.g. RAM timers)
+    void exclude(uint16_t addr, int num_bytes);
+    /// clear all excluded memory ranges
+    void clear_excludes();
+    /// forget the idle state (called on input)
+    void wake();
+    /// called after each emulated frame
+    void on_frame();
+    /// return true if the system is idle and the next frame can be skipped
+    bool can_skip() const;
+    /// called when a frame has been skipped
+    void on_skip(int micro_secs);
+
+    /// number of repeating frames until the system is considered idle
+    int idle_frames = 50;
+    /// max time to skip before emulating a frame
+    int max_skip_us = 500000;
+    /// number of skipped frames (for statistics)
+    uint64_t skipped_frames = 0;
+
+private:
+    /// tickhook observer, decodes memory writes from CPU pins
+    static void tick_observer(int num_ticks, uint64_t pins, void* user_data);
+    /// update the memory content hash
+    void write(uint16_t addr, uint8_t data);
+    /// mark the excluded memory ranges in the excluded bits
+    void apply_excludes();
+
+    bool enabled = false;
+    uint64_t hash = 0;
+    uint64_t last_pins = 0;
+    uint64_t history[history_size] = { };
+    int history_pos = 0;
+    int history_count = 0;
+    int repeat_count = 0;
+    int skipped_us = 0;
+    struct range {
+        uint16_t addr = 0;
+        int num_bytes = 0;
+    } excludes[max_excludes];
+    int num_excludes = 0;
+    struct tracking {
+        uint8_t shadow[0x10000];
+        uint8_t excluded[0x10000 / 8];
+    };
+    tracking* mem = nullptr;
+};
+
+} // namespace YAKC
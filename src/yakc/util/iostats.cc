@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+//  iostats.cc
+//------------------------------------------------------------------------------
+#include "iostats.h"
+#include "yakc/util/breadboard.h"
+#include <string.h>
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+iostats::~iostats() {
+    this->discard();
+}
+
+//------------------------------------------------------------------------------
+void
+iostats::enable() {
+    if (!this->enabled) {
+        if (!this->data) {
+            this->data = (counters*) YAKC_MALLOC(sizeof(counters));
+            memset(this->data, 0, sizeof(counters));
+        }
+        this->enabled = board.tickhook.add(tick_observer, this);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+iostats::disable() {
+    if (this->enabled) {
+        board.tickhook.remove(tick_observer, this);
+        this->enabled = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+iostats::discard() {
+    this->disable();
+    if (this->data) {
+        YAKC_FREE(this->data);
+        this->data = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+iostats::is_enabled() const {
+    return this->enabled;
+}
+
+//------------------------------------------------------------------------------
+int
+iostats::num_bytes() const {
+    return this->data ? int(sizeof(counters)) : 0;
+}
+
+//------------------------------------------------------------------------------
+void
+iostats::clear() {
+    if (this->data) {
+        memset(this->data, 0, sizeof(counters));
+    }
+    this->emulated_us = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+iostats::set_decoder(decode_func fn, int shift) {
+    YAKC_ASSERT((0 == shift) || (8 == shift));
+    this->decoder = fn;
+    this->port_shift = shift;
+}
+
+//------------------------------------------------------------------------------
+void
+iostats::on_frame(int micro_secs) {
+    if (this->enabled) {
+        this->emulated_us += micro_secs;
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+iostats::chip_index(chip::id c) {
+    for (int i = 0; i < num_chips; i++) {
+        if (c == (1<<i)) {
+            return i;
+        }
+    }
+    YAKC_ASSERT(false);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+void
+iostats::add(chip::id c, int reg, bool wr) {
+    YAKC_ASSERT((reg >= 0) && (reg < max_regs));
+    this->data->chips[chip_index(c)][reg][wr ? write : read]++;
+}
+
+//------------------------------------------------------------------------------
+void
+iostats::tick_observer(int /*num_ticks*/, uint64_t pins, void* user_data) {
+    iostats* self = (iostats*) user_data;
+    if (board.z80) {
+        // Z80: I/O requests without M1 (M1|IORQ is an interrupt acknowledge)
+        if ((pins & (Z80_IORQ|Z80_M1)) == Z80_IORQ) {
+            const bool wr = 0 != (pins & Z80_WR);
+            if (wr || (pins & Z80_RD)) {
+                const int port = ((pins & 0xFFFF) >> self->port_shift) & (num_ports - 1);
+                self->data->ports[port][wr ? write : read]++;
+                if (self->decoder) {
+                    self->decoder(pins, wr, *self);
+                }
+            }
+        }
+    }
+    else if (self->decoder) {
+        // 6502: each tick is a memory access, the decoder filters I/O addresses
+        self->decoder(pins, 0 == (pins & M6502_RW), *self);
+    }
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+iostats::count(chip::id c, access type) const {
+    const int i = chip_index(c);
+    uint32_t sum = 0;
+    if (this->data) {
+        for (int reg = 0; reg < max_regs; reg++) {
+            sum += this->data->chips[i][reg][type];
+        }
+    }
+    return sum;
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+iostats::reg_count(chip::id c, int reg, access type) const {
+    YAKC_ASSERT((reg >= 0) && (reg < max_regs));
+    return this->data ? this->data->chips[chip_index(c)][reg][type] : 0;
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+iostats::port_count(int port, access type) const {
+    YAKC_ASSERT((port >= 0) && (port < num_ports));
+    return this->data ? this->data->ports[port][type] : 0;
+}
+
+//------------------------------------------------------------------------------
+double
+iostats::seconds() const {
+    return this->emulated_us / 1000000.0;
+}
+
+//------------------------------------------------------------------------------
+double
+iostats::rate(uint32_t count) const {
+    return (this->emulated_us > 0) ? (count * 1000000.0) / this->emulated_us : 0.0;
+}
+
+} // namespace YAKC
@@ -0,0 +1,93 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::iostats
+    @brief count I/O accesses per port, per chip and per chip register
+
+    Z80 IN/OUT requests are counted per 8-bit I/O port, and both Z80
+    I/O requests and 6502 memory-mapped I/O accesses are counted per
+    chip (chip::id) and chip register. Since only the system knows
+    which chip is selected by an I/O address, each system provides
+    a decoder function, which is set by yakc at poweron.
+
+    The counters are accumulated until cleared, together with the
+    emulated time, so that access rates per emulated second can
+    be computed.
+
+    Like memstats, the counting is only hooked into the CPU tick
+    callback while enabled, and the counters are allocated on the
+    first enable() and freed with discard().
+*/
+#include "yakc/util/core.h"
+
+namespace YAKC {
+
+class iostats {
+public:
+    /// access types
+    enum access {
+        read = 0,
+        write,
+
+        num_access_types
+    };
+    /// number of chip ids
+    static const int num_chips = 14;
+    /// max number of registers per chip
+    static const int max_regs = 64;
+    /// number of I/O ports (Z80 only)
+    static const int num_ports = 256;
+    /// a system-specific decoder, calls add() for each chip register access
+    typedef void (*decode_func)(uint64_t pins, bool write, iostats& stats);
+
+    /// destructor
+    ~iostats();
+    /// start counting I/O accesses
+    void enable();
+    /// stop counting I/O accesses (keeps the counters)
+    void disable();
+    /// stop counting I/O accesses and free the counters
+    void discard();
+    /// return true if enabled
+    bool is_enabled() const;
+    /// number of allocated bytes
+    int num_bytes() const;
+    /// reset all counters and the emulated time
+    void clear();
+    /// set the system decoder and port shift (8 if ports are decoded by the upper address byte)
+    void set_decoder(decode_func fn, int port_shift);
+    /// accumulate the emulated time, called once per frame
+    void on_frame(int micro_secs);
+
+    /// count a chip register access (called by decoder functions)
+    void add(chip::id c, int reg, bool write);
+
+    /// get the number of accesses to a chip
+    uint32_t count(chip::id c, access type) const;
+    /// get the number of accesses to a chip register
+    uint32_t reg_count(chip::id c, int reg, access type) const;
+    /// get the number of accesses to an I/O port
+    uint32_t port_count(int port, access type) const;
+    /// get the emulated time in seconds since last clear
+    double seconds() const;
+    /// convert a counter value to a rate per emulated second
+    double rate(uint32_t count) const;
+
+private:
+    /// tickhook observer, decodes I/O accesses from CPU pins
+    static void tick_observer(int num_ticks, uint64_t pins, void* user_data);
+    /// convert a chip id bit to an array index
+    static int chip_index(chip::id c);
+
+    struct counters {
+        uint32_t chips[num_chips][max_regs][num_access_types];
+        uint32_t ports[num_ports][num_access_types];
+    };
+    bool enabled = false;
+    decode_func decoder = nullptr;
+    int port_shift = 0;
+    uint64_t emulated_us = 0;
+    counters* data = nullptr;
+};
+
+} // namespace YAKC
@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+//  mapped_file.cc
+//------------------------------------------------------------------------------
+#include "mapped_file.h"
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+mapped_file::~mapped_file() {
+    this->close();
+}
+
+//------------------------------------------------------------------------------
+bool
+mapped_file::open(const char* path) {
+    YAKC_ASSERT(path);
+    this->close();
+    #if defined(_WIN32)
+    HANDLE fh = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fh == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(fh, &size) || (size.QuadPart == 0) || (size.QuadPart > 0x7FFFFFFF)) {
+        CloseHandle(fh);
+        return false;
+    }
+    HANDLE mh = CreateFileMappingA(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mh) {
+        CloseHandle(fh);
+        return false;
+    }
+    const void* ptr = MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0);
+    if (!ptr) {
+        CloseHandle(mh);
+        CloseHandle(fh);
+        return false;
+    }
+    this->file_handle = fh;
+    this->map_handle = mh;
+    this->data = (const uint8_t*) ptr;
+    this->num_bytes = (int) size.QuadPart;
+    return true;
+    #elif defined(__EMSCRIPTEN__)
+    return false;
+    #else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (st.st_size == 0) || (st.st_size > 0x7FFFFFFF)) {
+        ::close(fd);
+        return false;
+    }
+    void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after closing the file descriptor
+    ::close(fd);
+    if (ptr == MAP_FAILED) {
+        return false;
+    }
+    this->data = (const uint8_t*) ptr;
+    this->num_bytes = (int) st.st_size;
+    return true;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+mapped_file::close() {
+    if (this->data) {
+        #if defined(_WIN32)
+        UnmapViewOfFile(this->data);
+        CloseHandle((HANDLE)this->map_handle);
+        CloseHandle((HANDLE)this->file_handle);
+        this->map_handle = nullptr;
+        this->file_handle = nullptr;
+        #elif !defined(__EMSCRIPTEN__)
+        munmap((void*)this->data, this->num_bytes);
+        #endif
+        this->data = nullptr;
+        this->num_bytes = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+mapped_file::is_open() const {
+    return nullptr != this->data;
+}
+
+//------------------------------------------------------------------------------
+const uint8_t*
+mapped_file::ptr() const {
+    return this->data;
+}
+
+//------------------------------------------------------------------------------
+int
+mapped_file::size() const {
+    return this->num_bytes;
+}
+
+} // namespace YAKC
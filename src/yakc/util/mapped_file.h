@@ -0,0 +1,49 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::mapped_file
+    @brief map a local file read-only into memory
+
+    The file content is accessible through ptr() without copying until
+    the file is closed (or the mapped_file object is destroyed). This
+    is used to register ROM images and program files by reference
+    with rom_images and filesystem.
+
+    Memory-mapping isn't supported on emscripten, open() will always
+    fail there.
+*/
+#include "yakc/util/core.h"
+
+namespace YAKC {
+
+class mapped_file {
+public:
+    /// constructor
+    mapped_file() { };
+    /// destructor, unmaps the file
+    ~mapped_file();
+    /// no copying
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    /// map a file, returns false if failed
+    bool open(const char* path);
+    /// unmap the file
+    void close();
+    /// return true if a file is mapped
+    bool is_open() const;
+    /// pointer to the mapped file content
+    const uint8_t* ptr() const;
+    /// size of the mapped file content
+    int size() const;
+
+private:
+    const uint8_t* data = nullptr;
+    int num_bytes = 0;
+    #if defined(_WIN32)
+    void* file_handle = nullptr;
+    void* map_handle = nullptr;
+    #endif
+};
+
+} // namespace YAKC
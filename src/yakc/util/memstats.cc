@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+//  memstats.cc
+//------------------------------------------------------------------------------
+#include "memstats.h"
+#include "yakc/util/breadboard.h"
+#include <string.h>
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+memstats::~memstats() {
+    this->discard();
+}
+
+//------------------------------------------------------------------------------
+void
+memstats::enable() {
+    if (!this->enabled) {
+        if (!this->counters) {
+            this->counters = (uint32_t*) YAKC_MALLOC(counters_size);
+            memset(this->counters, 0, counters_size);
+        }
+        this->enabled = board.tickhook.add(tick_observer, this);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+memstats::disable() {
+    if (this->enabled) {
+        board.tickhook.remove(tick_observer, this);
+        this->enabled = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+memstats::discard() {
+    this->disable();
+    if (this->counters) {
+        YAKC_FREE(this->counters);
+        this->counters = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+memstats::is_enabled() const {
+    return this->enabled;
+}
+
+//------------------------------------------------------------------------------
+int
+memstats::num_bytes() const {
+    if (this->counters) {
+        return counters_size;
+    }
+    else {
+        return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+uint32_t*
+memstats::cells(access type) const {
+    return this->counters + type * num_cells;
+}
+
+//------------------------------------------------------------------------------
+void
+memstats::clear() {
+    if (this->counters) {
+        memset(this->counters, 0, counters_size);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+memstats::decay() {
+    if (this->counters && (this->decay_shift > 0)) {
+        for (int type = 0; type < num_access_types; type++) {
+            uint32_t* c = this->cells((access)type);
+            for (int i = 0; i < num_cells; i++) {
+                c[i] -= (c[i] + (1<<this->decay_shift) - 1) >> this->decay_shift;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+memstats::tick_observer(int /*num_ticks*/, uint64_t pins, void* user_data) {
+    memstats* self = (memstats*) user_data;
+    const int cell = (pins & 0xFFFF) >> cell_shift;
+    if (board.z80) {
+        // Z80: only memory requests with read or write are accesses,
+        // a read with M1 active is an opcode fetch
+        if ((pins & (Z80_MREQ|Z80_RD)) == (Z80_MREQ|Z80_RD)) {
+            self->cells((pins & Z80_M1) ? exec : read)[cell]++;
+        }
+        else if ((pins & (Z80_MREQ|Z80_WR)) == (Z80_MREQ|Z80_WR)) {
+            self->cells(write)[cell]++;
+        }
+    }
+    else {
+        // 6502: each tick is a memory access, SYNC is an opcode fetch
+        if (pins & M6502_SYNC) {
+            self->cells(exec)[cell]++;
+        }
+        else {
+            self->cells((pins & M6502_RW) ? read : write)[cell]++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+memstats::count(access type, int cell) const {
+    YAKC_ASSERT((type >= 0) && (type < num_access_types));
+    YAKC_ASSERT((cell >= 0) && (cell < num_cells));
+    return this->counters ? this->cells(type)[cell] : 0;
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+memstats::sum(access type, uint16_t addr, int num_bytes) const {
+    YAKC_ASSERT((type >= 0) && (type < num_access_types));
+    if (!this->counters) {
+        return 0;
+    }
+    const int first = addr >> cell_shift;
+    const int last = (addr + num_bytes - 1) >> cell_shift;
+    uint32_t s = 0;
+    for (int i = first; (i <= last) && (i < num_cells); i++) {
+        s += this->cells(type)[i];
+    }
+    return s;
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+memstats::max_count(access type) const {
+    YAKC_ASSERT((type >= 0) && (type < num_access_types));
+    uint32_t m = 0;
+    if (this->counters) {
+        const uint32_t* c = this->cells(type);
+        for (int i = 0; i < num_cells; i++) {
+            if (c[i] > m) {
+                m = c[i];
+            }
+        }
+    }
+    return m;
+}
+
+} // namespace YAKC
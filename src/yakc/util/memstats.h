@@ -0,0 +1,74 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::memstats
+    @brief count CPU memory reads, writes and instruction fetches
+
+    Memory accesses are counted per 16-byte cell of the 64 KByte CPU
+    address space through the tickhook, and the counters decay a bit
+    each frame so that they reflect recent activity.
+
+    The counting is only hooked into the CPU tick callback while
+    enabled, so there's no overhead when statistics are disabled.
+    The counters are allocated on the first enable() and freed
+    with discard().
+*/
+#include "yakc/util/core.h"
+
+namespace YAKC {
+
+class memstats {
+public:
+    /// access types
+    enum access {
+        read = 0,
+        write,
+        exec,
+
+        num_access_types
+    };
+    /// number of address bits per cell
+    static const int cell_shift = 4;
+    /// number of cells in the 64 KByte address space
+    static const int num_cells = 0x10000 >> cell_shift;
+
+    /// destructor
+    ~memstats();
+    /// start counting memory accesses
+    void enable();
+    /// stop counting memory accesses (keeps the counters)
+    void disable();
+    /// stop counting memory accesses and free the counters
+    void discard();
+    /// return true if enabled
+    bool is_enabled() const;
+    /// number of allocated bytes
+    int num_bytes() const;
+    /// reset all counters to zero
+    void clear();
+    /// decay counters, called once per frame
+    void decay();
+
+    /// get the counter of a cell
+    uint32_t count(access type, int cell) const;
+    /// get the sum of counters in an address range (in cell granularity)
+    uint32_t sum(access type, uint16_t addr, int num_bytes) const;
+    /// get the max counter value over all cells
+    uint32_t max_count(access type) const;
+
+    /// counters lose 1/2^decay_shift of their value each frame (0: no decay)
+    int decay_shift = 3;
+
+private:
+    /// tickhook observer, decodes memory accesses from CPU pins
+    static void tick_observer(int num_ticks, uint64_t pins, void* user_data);
+
+    /// get the counters of an access type
+    uint32_t* cells(access type) const;
+
+    bool enabled = false;
+    uint32_t* counters = nullptr;   // num_access_types * num_cells
+    static const int counters_size = num_access_types * num_cells * sizeof(uint32_t);
+};
+
+} // namespace YAKC
@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+//  paste.cc
+//------------------------------------------------------------------------------
+#include "paste.h"
+#include "yakc/yakc.h"
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+paste::~paste() {
+    this->stop();
+}
+
+//------------------------------------------------------------------------------
+void
+paste::start(const uint8_t* ptr, int num_bytes) {
+    this->stop();
+    if (ptr && (num_bytes > 0)) {
+        this->text = (uint8_t*) YAKC_MALLOC(num_bytes);
+        memcpy(this->text, ptr, num_bytes);
+        this->size = num_bytes;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+paste::stop() {
+    if (this->text) {
+        YAKC_FREE(this->text);
+        this->text = nullptr;
+    }
+    this->size = 0;
+    this->pos = 0;
+    this->wait_us = 0;
+    this->busy_us = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+paste::is_active() const {
+    return nullptr != this->text;
+}
+
+//------------------------------------------------------------------------------
+void
+paste::update(yakc& emu, int micro_secs) {
+    if (!this->text) {
+        return;
+    }
+    if (this->wait_us > 0) {
+        this->wait_us -= micro_secs;
+    }
+    while ((this->wait_us <= 0) && (this->pos < this->size)) {
+        // filter out unwanted characters and convert
+        uint8_t chr = this->text[this->pos];
+        if ((0 == chr) || ('\t' == chr) || ('\r' == chr)) {
+            this->pos++;
+            continue;
+        }
+        if ('\n' == chr) {
+            chr = 0x0D;
+        }
+        paste_result res = emu.paste_char(chr);
+        if (paste_result::busy == res) {
+            // wait until the OS has taken characters out of the buffer,
+            // unless it doesn't seem to read the buffer at all
+            this->busy_us += micro_secs;
+            if (this->busy_us < this->busy_timeout_us) {
+                break;
+            }
+            res = paste_result::unsupported;
+        }
+        this->busy_us = 0;
+        this->pos++;
+        if (paste_result::unsupported == res) {
+            // press the key in the keyboard matrix, and give the
+            // system time to scan the keyboard
+            emu.on_ascii(chr);
+            this->wait_us = emu.is_system(system::any_c64) ? this->c64_matrix_delay_us : this->matrix_delay_us;
+        }
+    }
+    if (this->pos >= this->size) {
+        this->stop();
+    }
+}
+
+} // namespace YAKC
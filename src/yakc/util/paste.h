@@ -0,0 +1,58 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::paste
+    @brief feed text into the emulated system as keyboard input
+
+    On systems which have a keyboard buffer in a known RAM location
+    (currently the C64 KERNAL), characters are written directly into the
+    buffer whenever the operating system has room for them. All other
+    characters and systems fall back to pressing keys in the emulated
+    keyboard matrix, with a delay between characters which is measured
+    in emulated time (so pasting works the same at any emulation speed).
+
+    While pasting is active, the emulator runs at max speed if
+    yakc::fast_paste is enabled.
+*/
+#include "yakc/util/core.h"
+
+namespace YAKC {
+
+class yakc;
+
+/// result of trying to write a character into the keyboard buffer
+enum class paste_result {
+    ok,             // character has been written to the keyboard buffer
+    busy,           // keyboard buffer is full, try again later
+    unsupported,    // character must go through the keyboard matrix
+};
+
+class paste {
+public:
+    /// destructor
+    ~paste();
+    /// start pasting text (the text is copied)
+    void start(const uint8_t* text, int num_bytes);
+    /// stop pasting and free the text
+    void stop();
+    /// return true while pasting
+    bool is_active() const;
+    /// feed characters, called before each emulated time slice
+    void update(yakc& emu, int micro_secs);
+
+    /// time between characters through the keyboard matrix
+    int matrix_delay_us = 166000;
+    /// time between characters through the keyboard matrix on the C64
+    int c64_matrix_delay_us = 33000;
+    /// give up on a full keyboard buffer and use the matrix after this time
+    int busy_timeout_us = 500000;
+
+private:
+    uint8_t* text = nullptr;
+    int size = 0;
+    int pos = 0;
+    int wait_us = 0;
+    int busy_us = 0;
+};
+
+} // namespace YAKC
@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------
+//  profiler.cc
+//------------------------------------------------------------------------------
+#include "profiler.h"
+#include <string.h>
+#include <algorithm>
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+void
+profiler::enable() {
+    if (!this->enabled) {
+        this->clear();
+        this->enabled = true;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+profiler::disable() {
+    // only stop between frames, so that open scopes are still closed
+    this->enabled = false;
+}
+
+//------------------------------------------------------------------------------
+bool
+profiler::is_enabled() const {
+    return this->enabled;
+}
+
+//------------------------------------------------------------------------------
+void
+profiler::clear() {
+    memset(this->cur, 0, sizeof(this->cur));
+    memset(this->frames, 0, sizeof(this->frames));
+    this->head = 0;
+    this->num_valid = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+profiler::begin(section s) {
+    YAKC_ASSERT((s >= 0) && (s < num_sections));
+    const clock::time_point now = clock::now();
+    if (this->depth > 0) {
+        // pause the outer section
+        const section outer = this->stack[std::min(this->depth, int(max_depth)) - 1];
+        this->cur[outer] += std::chrono::duration<float, std::micro>(now - this->start).count();
+    }
+    if (this->depth < max_depth) {
+        this->stack[this->depth] = s;
+    }
+    this->depth++;
+    this->start = now;
+}
+
+//------------------------------------------------------------------------------
+void
+profiler::end() {
+    YAKC_ASSERT(this->depth > 0);
+    const clock::time_point now = clock::now();
+    const section s = this->stack[std::min(this->depth, int(max_depth)) - 1];
+    this->cur[s] += std::chrono::duration<float, std::micro>(now - this->start).count();
+    this->depth--;
+    this->start = now;
+}
+
+//------------------------------------------------------------------------------
+void
+profiler::end_frame() {
+    float* frame = this->frames[this->head];
+    float total = 0.0f;
+    for (int i = 0; i < num_sections; i++) {
+        frame[i] = this->cur[i];
+        total += this->cur[i];
+        this->cur[i] = 0.0f;
+    }
+    frame[num_sections] = total;
+    this->head = (this->head + 1) % num_frames;
+    if (this->num_valid < num_frames) {
+        this->num_valid++;
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+profiler::num_valid_frames() const {
+    return this->num_valid;
+}
+
+//------------------------------------------------------------------------------
+float
+profiler::frame_time(int sec, int frame) const {
+    YAKC_ASSERT((sec >= 0) && (sec <= num_sections));
+    if ((frame < 0) || (frame >= this->num_valid)) {
+        return 0.0f;
+    }
+    const int index = (this->head - this->num_valid + frame + num_frames) % num_frames;
+    return this->frames[index][sec];
+}
+
+//------------------------------------------------------------------------------
+float
+profiler::percentile(int sec, float p) const {
+    YAKC_ASSERT((sec >= 0) && (sec <= num_sections));
+    if (0 == this->num_valid) {
+        return 0.0f;
+    }
+    float values[num_frames];
+    for (int i = 0; i < this->num_valid; i++) {
+        values[i] = this->frame_time(sec, i);
+    }
+    int n = int((p / 100.0f) * (this->num_valid - 1) + 0.5f);
+    n = std::max(0, std::min(n, this->num_valid - 1));
+    std::nth_element(values, values + n, values + this->num_valid);
+    return values[n];
+}
+
+//------------------------------------------------------------------------------
+const char*
+profiler::name(int sec) {
+    switch (sec) {
+        case other:     return "other";
+        case system:    return "system";
+        case audio:     return "audio";
+        case input:     return "input";
+        default:        return "total";
+    }
+}
+
+} // namespace YAKC
@@ -0,0 +1,124 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::profiler
+    @brief per-frame breakdown of the host time spent in the emulator
+
+    The host time of each emulated frame is split into sections (system
+    emulation, audio output, input handling and the per-frame overhead
+    of the yakc wrapper), and the last num_frames frames are kept in a
+    rolling window for percentile statistics.
+
+    Sections are measured with YAKC_PROFILE_SCOPE(section) and may be
+    nested, the time of a nested section is subtracted from the outer
+    section. YAKC_PROFILE_FRAME() measures the frame overhead and closes
+    the frame when leaving the scope.
+
+    The chips emulators decode video and generate audio samples inside
+    the per-tick callback, this is included in the 'system' section,
+    only pushing the samples into the audio buffer is measured
+    separately.
+
+    When built with FIPS_PROFILING (YAKC_PROFILING), the same scopes
+    are also sent to Remotery, independent from the enabled flag.
+*/
+#include "yakc/util/core.h"
+#include <chrono>
+#if YAKC_PROFILING
+#include "Remotery.h"
+#endif
+
+namespace YAKC {
+
+class profiler {
+public:
+    /// the measured sections
+    enum section {
+        other = 0,      // frame overhead (rewinder, debugger, idle detection)
+        system,         // CPU and chips, including video decoding
+        audio,          // pushing samples into the audio buffer
+        input,          // keyboard, joystick and paste input
+
+        num_sections
+    };
+    /// number of frames in the rolling window
+    static const int num_frames = 256;
+
+    /// start measuring
+    void enable();
+    /// stop measuring
+    void disable();
+    /// return true if enabled
+    bool is_enabled() const;
+    /// clear the rolling window
+    void clear();
+
+    /// start a section (called by scope)
+    void begin(section s);
+    /// end the current section (called by scope)
+    void end();
+    /// store the current frame in the rolling window
+    void end_frame();
+
+    /// number of valid frames in the rolling window
+    int num_valid_frames() const;
+    /// host time of a section in microseconds, frame 0 is the oldest, num_sections for the frame total
+    float frame_time(int sec, int frame) const;
+    /// percentile (0..100) of a section in the rolling window in microseconds
+    float percentile(int sec, float p) const;
+    /// get the human-readable name of a section
+    static const char* name(int sec);
+
+    /// measure a section while in scope
+    struct scope {
+        scope(profiler& p, section s) : prof(p.enabled ? &p : nullptr) {
+            if (prof) {
+                prof->begin(s);
+            }
+        };
+        ~scope() {
+            if (prof) {
+                prof->end();
+            }
+        };
+        profiler* prof;
+    };
+    /// measure the frame overhead, and close the frame when leaving scope
+    struct frame_scope {
+        frame_scope(profiler& p) : prof(p.enabled ? &p : nullptr) {
+            if (prof) {
+                prof->begin(other);
+            }
+        };
+        ~frame_scope() {
+            if (prof) {
+                prof->end();
+                prof->end_frame();
+            }
+        };
+        profiler* prof;
+    };
+
+private:
+    typedef std::chrono::steady_clock clock;
+    static const int max_depth = 8;
+
+    bool enabled = false;
+    clock::time_point start;
+    int depth = 0;
+    section stack[max_depth];
+    float cur[num_sections] = { };
+    float frames[num_frames][num_sections + 1] = { };
+    int head = 0;
+    int num_valid = 0;
+};
+
+} // namespace YAKC
+
+#if YAKC_PROFILING
+#define YAKC_PROFILE_SCOPE(sec) rmt_ScopedCPUSample(yakc_##sec, 0); YAKC::profiler::scope yakc_profile_##sec(YAKC::board.profiler, YAKC::profiler::sec)
+#define YAKC_PROFILE_FRAME() rmt_ScopedCPUSample(yakc_frame, 0); YAKC::profiler::frame_scope yakc_profile_frame(YAKC::board.profiler)
+#else
+#define YAKC_PROFILE_SCOPE(sec) YAKC::profiler::scope yakc_profile_##sec(YAKC::board.profiler, YAKC::profiler::sec)
+#define YAKC_PROFILE_FRAME() YAKC::profiler::frame_scope yakc_profile_frame(YAKC::board.profiler)
+#endif
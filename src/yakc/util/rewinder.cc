@@ -0,0 +1,276 @@
+//------------------------------------------------------------------------------
+//  rewinder.cc
+//------------------------------------------------------------------------------
+#include "rewinder.h"
+#include "yakc/yakc.h"
+#include "yakc/util/breadboard.h"
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+void
+rewinder::enable(int size) {
+    YAKC_ASSERT(size > 0);
+    if (this->is_enabled()) {
+        this->disable();
+    }
+    this->snapshot_size = size;
+    this->num_slots = this->max_bytes / size;
+    if (this->num_slots < 2) {
+        this->num_slots = 2;
+    }
+    this->ring = (snapshot*) YAKC_MALLOC(this->num_slots * sizeof(snapshot));
+    for (int i = 0; i < this->num_slots; i++) {
+        this->ring[i] = snapshot();
+    }
+    this->clear();
+    board.tickhook.add(tick_observer, this);
+}
+
+//------------------------------------------------------------------------------
+void
+rewinder::disable() {
+    if (this->ring) {
+        board.tickhook.remove(tick_observer, this);
+        for (int i = 0; i < this->num_slots; i++) {
+            if (this->ring[i].data) {
+                YAKC_FREE(this->ring[i].data);
+            }
+        }
+        YAKC_FREE(this->ring);
+        this->ring = nullptr;
+    }
+    this->num_slots = 0;
+    this->snapshot_size = 0;
+    this->clear();
+}
+
+//------------------------------------------------------------------------------
+bool
+rewinder::is_enabled() const {
+    return nullptr != this->ring;
+}
+
+//------------------------------------------------------------------------------
+void
+rewinder::clear() {
+    this->head = 0;
+    this->count = 0;
+    this->instr = 0;
+    this->prefix = prefix_none;
+}
+
+//------------------------------------------------------------------------------
+int
+rewinder::num_snapshots() const {
+    return this->count;
+}
+
+//------------------------------------------------------------------------------
+int
+rewinder::num_bytes() const {
+    int num = 0;
+    for (int i = 0; i < this->num_slots; i++) {
+        if (this->ring[i].data) {
+            num += this->snapshot_size;
+        }
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+void
+rewinder::tick_observer(int /*num_ticks*/, uint64_t pins, void* user_data) {
+    rewinder* self = (rewinder*) user_data;
+    if (board.z80) {
+        if ((pins & (Z80_M1|Z80_MREQ|Z80_RD)) == (Z80_M1|Z80_MREQ|Z80_RD)) {
+            self->z80_fetch(mem_rd(board.mem, pins & 0xFFFF));
+        }
+    }
+    else if (pins & M6502_SYNC) {
+        self->instr++;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+rewinder::z80_fetch(uint8_t op) {
+    switch (this->prefix) {
+        case prefix_none:
+            this->instr++;
+            if ((op == 0xCB) || (op == 0xED)) {
+                this->prefix = prefix_cb_ed;
+            }
+            else if ((op == 0xDD) || (op == 0xFD)) {
+                this->prefix = prefix_index;
+            }
+            break;
+        case prefix_cb_ed:
+            this->prefix = prefix_none;
+            break;
+        case prefix_index:
+            // DD CB d op only has 2 opcode fetches
+            if (op == 0xED) {
+                this->prefix = prefix_cb_ed;
+            }
+            else if ((op != 0xDD) && (op != 0xFD)) {
+                this->prefix = prefix_none;
+            }
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+rewinder::ring_index(int n) const {
+    YAKC_ASSERT((n >= 0) && (n < this->num_slots));
+    return (this->head + n) % this->num_slots;
+}
+
+//------------------------------------------------------------------------------
+int
+rewinder::find(uint64_t at_instr) const {
+    for (int n = this->count - 1; n >= 0; n--) {
+        if (this->ring[this->ring_index(n)].instr <= at_instr) {
+            return n;
+        }
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+void
+rewinder::restore(yakc& emu, int n) {
+    const snapshot& snap = this->ring[this->ring_index(n)];
+    emu.load_snapshot(snap.data);
+    this->instr = snap.instr;
+    this->prefix = snap.prefix;
+}
+
+//------------------------------------------------------------------------------
+void
+rewinder::replay_to(yakc& emu, uint64_t end_instr) {
+    while (this->instr < end_instr) {
+        if (0 == emu.replay_step()) {
+            break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+uint16_t
+rewinder::cur_pc() {
+    if (board.z80) {
+        return z80_pc(board.z80);
+    }
+    else if (board.m6502) {
+        return board.m6502->state.PC;
+    }
+    else {
+        return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+rewinder::on_frame(yakc& emu) {
+    if (!this->ring) {
+        return;
+    }
+    // drop snapshots 'from the future' after going back in time
+    while ((this->count > 0) && (this->ring[this->ring_index(this->count-1)].instr > this->instr)) {
+        this->count--;
+    }
+    // if no instruction was executed since the last snapshot (e.g. a
+    // skipped idle frame), the state may still have changed through
+    // frame input, so the last snapshot is replaced
+    int index;
+    if ((this->count > 0) && (this->ring[this->ring_index(this->count-1)].instr == this->instr)) {
+        index = this->ring_index(this->count-1);
+    }
+    else if (this->count < this->num_slots) {
+        index = this->ring_index(this->count++);
+    }
+    else {
+        // ring buffer full, overwrite oldest snapshot
+        index = this->head;
+        this->head = (this->head + 1) % this->num_slots;
+    }
+    snapshot& snap = this->ring[index];
+    if (!snap.data) {
+        snap.data = (uint8_t*) YAKC_MALLOC(this->snapshot_size);
+    }
+    emu.save_snapshot(snap.data);
+    snap.instr = this->instr;
+    snap.prefix = this->prefix;
+}
+
+//------------------------------------------------------------------------------
+bool
+rewinder::step_back(yakc& emu) {
+    if (this->instr == 0) {
+        return false;
+    }
+    const uint64_t target = this->instr - 1;
+    const int n = this->find(target);
+    if (n < 0) {
+        return false;
+    }
+    this->restore(emu, n);
+    this->replay_to(emu, target);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+rewinder::run_back_to(yakc& emu, uint16_t addr) {
+    const uint64_t cur_instr = this->instr;
+    uint64_t end_instr = cur_instr;
+    for (int n = this->find(cur_instr); n >= 0; n--) {
+        // replay the time span between this and the next snapshot,
+        // and remember the last position at the requested address
+        this->restore(emu, n);
+        const uint64_t start_instr = this->instr;
+        bool hit = false;
+        uint64_t hit_instr = 0;
+        while (this->instr < end_instr) {
+            if (cur_pc() == addr) {
+                hit = true;
+                hit_instr = this->instr;
+            }
+            if (0 == emu.replay_step()) {
+                break;
+            }
+        }
+        if (hit) {
+            this->restore(emu, n);
+            this->replay_to(emu, hit_instr);
+            return true;
+        }
+        end_instr = start_instr;
+    }
+    // not found, go back to the original position
+    const int n = this->find(cur_instr);
+    if (n >= 0) {
+        this->restore(emu, n);
+        this->replay_to(emu, cur_instr);
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool
+rewinder::reverse_continue(yakc& emu) {
+    if (board.dbg.breakpoint_enabled()) {
+        if (this->run_back_to(emu, board.dbg.breakpoint_addr())) {
+            return true;
+        }
+    }
+    if ((this->count > 0) && (this->ring[this->ring_index(0)].instr < this->instr)) {
+        this->restore(emu, 0);
+        return true;
+    }
+    return false;
+}
+
+} // namespace YAKC
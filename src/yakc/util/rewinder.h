@@ -0,0 +1,96 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::rewinder
+    @brief snapshot-based reverse execution for the debugger
+
+    While recording is active, the rewinder takes a machine state snapshot
+    at the start of each emulated frame into a ring buffer which is
+    limited to 'max_bytes', and counts the executed instructions through
+    the tickhook (opcode fetches, Z80 prefix bytes are part of the
+    instruction). Each snapshot stores the instruction count at which
+    it was taken.
+
+    Going backward in time is done by restoring the newest snapshot
+    at or before the target position and re-executing the difference
+    in instructions once, without adding them to the debugger history.
+
+    Keyboard, joystick, paste and tape input is processed between
+    exec calls by the system emulators, and can't be replayed by
+    stepping instructions. For a short time after input (and while
+    pasting or the tape motor is on), yakc takes a snapshot at every
+    exec call instead of once per frame, so a replay never crosses such
+    a state change. A target position whose snapshot has already been
+    dropped from the ring buffer can't be reached.
+*/
+#include "yakc/util/core.h"
+
+namespace YAKC {
+
+class yakc;
+
+class rewinder {
+public:
+    /// start recording with the snapshot size of the current system
+    void enable(int snapshot_size);
+    /// stop recording and free snapshot memory
+    void disable();
+    /// return true if recording
+    bool is_enabled() const;
+    /// throw away all recorded snapshots
+    void clear();
+    /// called at start of an emulated frame or after input, takes a snapshot
+    void on_frame(yakc& emu);
+
+    /// step back one instruction
+    bool step_back(yakc& emu);
+    /// go back to the previous execution of an instruction address
+    bool run_back_to(yakc& emu, uint16_t addr);
+    /// go back to previous breakpoint hit, or oldest recorded snapshot
+    bool reverse_continue(yakc& emu);
+
+    /// number of recorded snapshots
+    int num_snapshots() const;
+    /// number of allocated bytes
+    int num_bytes() const;
+
+    /// memory cap for snapshots
+    int max_bytes = 32 * 1024 * 1024;
+    /// current position in executed instructions since recording started
+    uint64_t instr = 0;
+
+private:
+    /// tickhook observer which counts executed instructions
+    static void tick_observer(int num_ticks, uint64_t pins, void* user_data);
+    /// count a Z80 opcode fetch, prefix bytes don't start a new instruction
+    void z80_fetch(uint8_t op);
+    /// get index of newest snapshot at or before an instruction position, or -1
+    int find(uint64_t at_instr) const;
+    /// get ring index of the n-th snapshot (0 is the oldest)
+    int ring_index(int n) const;
+    /// restore the n-th snapshot
+    void restore(yakc& emu, int n);
+    /// step forward until an instruction position is reached
+    void replay_to(yakc& emu, uint64_t end_instr);
+    /// get current CPU program counter
+    static uint16_t cur_pc();
+
+    enum prefix_state {
+        prefix_none,    // next opcode fetch starts an instruction
+        prefix_cb_ed,   // one more opcode fetch after a CB or ED prefix
+        prefix_index,   // one more opcode fetch after a DD or FD prefix
+    };
+    struct snapshot {
+        uint64_t instr = 0;
+        prefix_state prefix = prefix_none;  // a frame may end after a DD or FD prefix
+        uint8_t* data = nullptr;
+    };
+    snapshot* ring = nullptr;
+    int num_slots = 0;
+    int snapshot_size = 0;
+    int head = 0;       // ring index of oldest snapshot
+    int count = 0;      // number of valid snapshots
+    prefix_state prefix = prefix_none;
+};
+
+} // namespace YAKC
@@ -4,41 +4,307 @@
 #include "rom_images.h"
 
 namespace YAKC {
-uint8_t rom_images::buffer[rom_images::buf_size];
 rom_images roms;
 
 //------------------------------------------------------------------------------
-void
+rom_images::rom_images() {
+    for (int i = 0; i < num_roms; i++) {
+        this->roms[i] = -1;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
 rom_images::add(rom type, const uint8_t* ptr, int size) {
+    return this->add_image(type, ptr, size, true);
+}
+
+//------------------------------------------------------------------------------
+bool
+rom_images::add_ref(rom type, const uint8_t* ptr, int size) {
+    return this->add_image(type, ptr, size, false);
+}
+
+//------------------------------------------------------------------------------
+bool
+rom_images::add_image(rom type, const uint8_t* ptr, int size, bool copy) {
     YAKC_ASSERT((type >= 0) && (type < num_roms));
-    YAKC_ASSERT(!this->has(type));
-    YAKC_ASSERT((cur_pos + size) <= buf_size);
+    YAKC_ASSERT(ptr && (size > 0));
+    YAKC_ASSERT(!this->locked);
+    const uint32_t crc = crc32(ptr, size);
+    if (this->verify && ((size != expected_size(type)) || (crc != known_hash(type)))) {
+        return false;
+    }
+    if (this->has(type)) {
+        // adding the same ROM twice is harmless, but a slot can't be replaced
+        const image& img = this->images[this->roms[type]];
+        return (img.crc == crc) && (img.size == size) && (0 == memcmp(img.ptr, ptr, size));
+    }
+    int index = this->find_image(crc, ptr, size);
+    if (index < 0) {
+        YAKC_ASSERT(this->num_imgs < num_roms);
+        index = this->num_imgs++;
+        image& img = this->images[index];
+        if (copy) {
+            uint8_t* dst = this->alloc(size);
+            memcpy(dst, ptr, size);
+            img.ptr = dst;
+        }
+        else {
+            img.ptr = ptr;
+        }
+        img.crc = crc;
+        img.size = size;
+    }
+    this->roms[type] = index;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int
+rom_images::find_image(uint32_t crc, const uint8_t* ptr, int size) const {
+    for (int i = 0; i < this->num_imgs; i++) {
+        const image& img = this->images[i];
+        if ((img.crc == crc) && (img.size == size) && (0 == memcmp(img.ptr, ptr, size))) {
+            return i;
+        }
+    }
+    return -1;
+}
 
-    memcpy(&this->buffer[cur_pos], ptr, size);
-    this->roms[type].pos = this->cur_pos;
-    this->roms[type].size = size;
-    this->cur_pos += size;
+//------------------------------------------------------------------------------
+uint8_t*
+rom_images::alloc(int size) {
+    YAKC_ASSERT(size <= chunk_size);
+    if ((this->chunk_pos + size) > chunk_size) {
+        YAKC_ASSERT(this->num_chunks < max_chunks);
+        this->chunks[this->num_chunks++] = (uint8_t*) YAKC_MALLOC(chunk_size);
+        this->chunk_pos = 0;
+    }
+    uint8_t* ptr = this->chunks[this->num_chunks-1] + this->chunk_pos;
+    this->chunk_pos += size;
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+void
+rom_images::clear() {
+    for (int i = 0; i < this->num_chunks; i++) {
+        YAKC_FREE(this->chunks[i]);
+        this->chunks[i] = nullptr;
+    }
+    this->num_chunks = 0;
+    this->chunk_pos = chunk_size;
+    for (int i = 0; i < num_roms; i++) {
+        this->roms[i] = -1;
+    }
+    for (int i = 0; i < this->num_imgs; i++) {
+        this->images[i] = image();
+    }
+    this->num_imgs = 0;
+    this->locked = false;
+}
+
+//------------------------------------------------------------------------------
+void
+rom_images::lock() {
+    this->locked = true;
+}
+
+//------------------------------------------------------------------------------
+bool
+rom_images::is_locked() const {
+    return this->locked;
 }
 
 //------------------------------------------------------------------------------
 bool
 rom_images::has(rom type) const {
     YAKC_ASSERT((type >= 0) && (type < num_roms));
-    return -1 != this->roms[type].pos;
+    return this->roms[type] >= 0;
 }
 
 //------------------------------------------------------------------------------
-uint8_t*
-rom_images::ptr(rom type) {
+const uint8_t*
+rom_images::ptr(rom type) const {
     YAKC_ASSERT(this->has(type));
-    return &this->buffer[this->roms[type].pos];
+    return this->images[this->roms[type]].ptr;
 }
 
 //------------------------------------------------------------------------------
 int
 rom_images::size(rom type) const {
     YAKC_ASSERT(this->has(type));
-    return this->roms[type].size;
+    return this->images[this->roms[type]].size;
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+rom_images::hash(rom type) const {
+    YAKC_ASSERT(this->has(type));
+    return this->images[this->roms[type]].crc;
+}
+
+//------------------------------------------------------------------------------
+int
+rom_images::num_images() const {
+    return this->num_imgs;
+}
+
+//------------------------------------------------------------------------------
+int
+rom_images::num_bytes() const {
+    return this->num_chunks * chunk_size;
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+rom_images::crc32(const uint8_t* ptr, int size) {
+    // standard CRC32 (same as zlib), computed bitwise since it's only
+    // needed when a ROM is added
+    uint32_t crc = 0xFFFFFFFF;
+    for (int i = 0; i < size; i++) {
+        crc ^= ptr[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+//------------------------------------------------------------------------------
+namespace {
+
+struct rom_info {
+    const char* name;
+    const char* filename;
+    int size;
+    uint32_t crc32;         // known-good content hash
+};
+const rom_info rom_infos[rom_images::num_roms] = {
+    { "hc900",                  "hc900.852",                0x2000, 0xE6F4C0AB },
+    { "caos22",                 "caos22.852",               0x2000, 0x48D5624C },
+    { "caos31",                 "caos31.853",               0x2000, 0x639E4864 },
+    { "caos34",                 "caos34.853",               0x2000, 0xD0245A3E },
+    { "caos42e",                "caos42e.854",              0x2000, 0xEE273933 },
+    { "caos42c",                "caos42c.854",              0x1000, 0x57D9AB02 },
+    { "kc85_basic_rom",         "basic_c0.853",             0x2000, 0xDFE34B08 },
+    { "kc85_basic_mod",         "m006.rom",                 0x4000, 0xD7C43AF0 },
+    { "forth",                  "forth.853",                0x2000, 0x501DFA5F },
+    { "develop",                "develop.853",              0x2000, 0xFE5A79E7 },
+    { "texor",                  "texor.rom",                0x2000, 0x02263B40 },
+    { "zx48k",                  "amstrad_zx48k.bin",        0x4000, 0xDDEE531F },
+    { "zx128k_0",               "amstrad_zx128k_0.bin",     0x4000, 0xE76799D2 },
+    { "zx128k_1",               "amstrad_zx128k_1.bin",     0x4000, 0xB96A36BE },
+    { "cpc464_os",              "cpc464_os.bin",            0x4000, 0x815752DF },
+    { "cpc464_basic",           "cpc464_basic.bin",         0x4000, 0x7D9A3BAC },
+    { "cpc6128_os",             "cpc6128_os.bin",           0x4000, 0x0219BB74 },
+    { "cpc6128_basic",          "cpc6128_basic.bin",        0x4000, 0xCA6AF63D },
+    { "cpc6128_amsdos",         "cpc6128_amsdos.bin",       0x4000, 0x1FE22ECD },
+    { "z9001_basic_507_511",    "z9001_basic_507_511.bin",  0x2800, 0x99BF403A },
+    { "z9001_os12_1",           "z9001_os12_1.bin",         0x0800, 0x6846AFE2 },
+    { "z9001_os12_2",           "z9001_os12_2.bin",         0x0800, 0x20729E76 },
+    { "z9001_basic",            "z9001_basic.bin",          0x2000, 0xDFE34B08 },
+    { "kc87_os_2",              "kc87_os_2.bin",            0x2000, 0xE4ADE421 },
+    { "z9001_font",             "z9001_font.bin",           0x0800, 0xDD9C0F4E },
+    { "kc87_font_2",            "kc87_font_2.bin",          0x0800, 0x8984FFF3 },
+    { "z1013_mon202",           "z1013_mon202.bin",         0x0800, 0x5884EDAB },
+    { "z1013_mon_a2",           "z1013_mon_a2.bin",         0x0800, 0x98B19B10 },
+    { "z1013_font",             "z1013_font.bin",           0x0800, 0x7023088F },
+    { "kcc_os",                 "kcc_os.bin",               0x4000, 0x7F9AB3F7 },
+    { "kcc_basic",              "kcc_bas.bin",              0x4000, 0xCA6AF63D },
+    { "atom_basic",             "abasic.ic20",              0x2000, 0x289B7791 },
+    { "atom_float",             "afloat.ic21",              0x1000, 0x81D86AF7 },
+    { "atom_dos",               "dosrom.u15",               0x1000, 0xC431A9B7 },
+    { "c64_basic",              "c64_basic.bin",            0x2000, 0xF833D117 },
+    { "c64_char",               "c64_char.bin",             0x1000, 0xEC4272EE },
+    { "c64_kernalv3",           "c64_kernalv3.bin",         0x2000, 0xDBE3E7C7 },
+};
+
+// the ROM manifest, os_rom::none matches any os
+struct rom_manifest_entry {
+    system model;
+    os_rom os;
+    int num_roms;
+    rom_images::rom roms[rom_images::max_required];
+};
+const rom_manifest_entry rom_manifest[] = {
+    { system::kc85_2,           os_rom::caos_hc900,     1, { rom_images::hc900 } },
+    { system::kc85_2,           os_rom::caos_2_2,       1, { rom_images::caos22 } },
+    { system::kc85_3,           os_rom::caos_3_1,       2, { rom_images::caos31, rom_images::kc85_basic_rom } },
+    { system::kc85_3,           os_rom::caos_3_4,       2, { rom_images::caos34, rom_images::kc85_basic_rom } },
+    { system::kc85_4,           os_rom::caos_4_2,       3, { rom_images::caos42c, rom_images::caos42e, rom_images::kc85_basic_rom } },
+    { system::z1013_01,         os_rom::none,           2, { rom_images::z1013_mon202, rom_images::z1013_font } },
+    { system::z1013_16,         os_rom::none,           2, { rom_images::z1013_mon_a2, rom_images::z1013_font } },
+    { system::z1013_64,         os_rom::none,           2, { rom_images::z1013_mon_a2, rom_images::z1013_font } },
+    { system::z9001,            os_rom::none,           4, { rom_images::z9001_os12_1, rom_images::z9001_os12_2, rom_images::z9001_basic_507_511, rom_images::z9001_font } },
+    { system::kc87,             os_rom::none,           3, { rom_images::kc87_os_2, rom_images::z9001_basic, rom_images::kc87_font_2 } },
+    { system::zxspectrum48k,    os_rom::none,           1, { rom_images::zx48k } },
+    { system::zxspectrum128k,   os_rom::none,           2, { rom_images::zx128k_0, rom_images::zx128k_1 } },
+    { system::cpc464,           os_rom::none,           2, { rom_images::cpc464_os, rom_images::cpc464_basic } },
+    { system::cpc6128,          os_rom::none,           3, { rom_images::cpc6128_os, rom_images::cpc6128_basic, rom_images::cpc6128_amsdos } },
+    { system::kccompact,        os_rom::none,           2, { rom_images::kcc_os, rom_images::kcc_basic } },
+    { system::acorn_atom,       os_rom::none,           3, { rom_images::atom_basic, rom_images::atom_float, rom_images::atom_dos } },
+    { system::c64_pal,          os_rom::none,           3, { rom_images::c64_basic, rom_images::c64_char, rom_images::c64_kernalv3 } },
+};
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+const char*
+rom_images::name(rom type) {
+    YAKC_ASSERT((type >= 0) && (type < num_roms));
+    return rom_infos[type].name;
+}
+
+//------------------------------------------------------------------------------
+const char*
+rom_images::filename(rom type) {
+    YAKC_ASSERT((type >= 0) && (type < num_roms));
+    return rom_infos[type].filename;
+}
+
+//------------------------------------------------------------------------------
+int
+rom_images::expected_size(rom type) {
+    YAKC_ASSERT((type >= 0) && (type < num_roms));
+    return rom_infos[type].size;
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+rom_images::known_hash(rom type) {
+    YAKC_ASSERT((type >= 0) && (type < num_roms));
+    return rom_infos[type].crc32;
+}
+
+//------------------------------------------------------------------------------
+rom_images::rom
+rom_images::identify(const uint8_t* ptr, int size) {
+    YAKC_ASSERT(ptr);
+    const uint32_t crc = crc32(ptr, size);
+    for (int i = 0; i < num_roms; i++) {
+        if ((rom_infos[i].size == size) && (rom_infos[i].crc32 == crc)) {
+            return (rom) i;
+        }
+    }
+    return num_roms;
+}
+
+//------------------------------------------------------------------------------
+int
+rom_images::required(system model, os_rom os, rom* out_roms, int max_roms) {
+    YAKC_ASSERT(out_roms && (max_roms > 0));
+    for (const auto& entry : rom_manifest) {
+        if ((entry.model == model) && ((entry.os == os_rom::none) || (entry.os == os))) {
+            int i = 0;
+            for (; (i < entry.num_roms) && (i < max_roms); i++) {
+                out_roms[i] = entry.roms[i];
+            }
+            return i;
+        }
+    }
+    return 0;
 }
 
 } // namespace YAKC
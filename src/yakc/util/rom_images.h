@@ -3,6 +3,15 @@
 /**
     class YAKC::rom_images
     @brief storage for dynamically loaded ROM images
+
+    ROM images are verified against a table of known-good CRC32 content
+    hashes, and stored in a content-indexed image table, so that identical
+    images (e.g. the KC85/3 BASIC and the KC87 BASIC ROM) are only stored
+    once. Copied images are packed into separately allocated chunks, so
+    the store can grow without invalidating pointers to existing images.
+
+    After lock() has been called, the store is read-only and can be
+    shared by any number of emulator instances.
 */
 #include "yakc/util/core.h"
 
@@ -53,25 +62,75 @@ public:
         num_roms
     };
 
-    /// add a ROM blob
-    void add(rom type, const uint8_t* ptr, int size);
+    /// constructor
+    rom_images();
+    /// add a ROM blob (copies the data), return false if verification failed
+    bool add(rom type, const uint8_t* ptr, int size);
+    /// add a ROM blob by reference (data must remain valid), return false if verification failed
+    bool add_ref(rom type, const uint8_t* ptr, int size);
+    /// free all ROM images and chunks
+    void clear();
+    /// make the store read-only, no ROMs can be added after this
+    void lock();
+    /// test if the store is read-only
+    bool is_locked() const;
     /// test if a ROM blob had been added
     bool has(rom type) const;
     /// get the pointer to a rom blob
-    uint8_t* ptr(rom type);
+    const uint8_t* ptr(rom type) const;
     /// get the size of a rom blob
     int size(rom type) const;
+    /// get the content hash of a rom blob
+    uint32_t hash(rom type) const;
+    /// number of unique ROM images in the store
+    int num_images() const;
+    /// number of bytes allocated for copied ROM images
+    int num_bytes() const;
+    /// reject ROM images which don't match the known-good content hash
+    bool verify = true;
+
+    /// compute CRC32 content hash of a chunk of data
+    static uint32_t crc32(const uint8_t* ptr, int size);
+    /// get the known-good content hash of a rom type
+    static uint32_t known_hash(rom type);
+    /// identify a ROM image by content (first match), returns num_roms if unknown
+    static rom identify(const uint8_t* ptr, int size);
+    /// get a human-readable name for a rom type
+    static const char* name(rom type);
+    /// get the file name of a rom type
+    static const char* filename(rom type);
+    /// get the expected size of a rom type in bytes
+    static int expected_size(rom type);
+    /// get the ROMs required by a system/os combination, returns number of ROMs (0 if unknown)
+    static int required(system model, os_rom os, rom* out_roms, int max_roms);
+    /// max number of ROMs required by any system
+    static const int max_required = 4;
 
 private:
-    struct item {
-        item() : pos(-1), size(0) { };
-        int pos;
-        int size;
-    } roms[num_roms];
+    /// common code for add() and add_ref()
+    bool add_image(rom type, const uint8_t* ptr, int size, bool copy);
+    /// find a stored image by content, return image index or -1
+    int find_image(uint32_t crc, const uint8_t* ptr, int size) const;
+    /// allocate bytes from the chunk list
+    uint8_t* alloc(int size);
+
+    // a unique ROM image, there can't be more than num_roms images
+    struct image {
+        uint32_t crc = 0;
+        const uint8_t* ptr = nullptr;
+        int size = 0;
+    } images[num_roms];
+    int num_imgs = 0;
+    // image index per ROM type, or -1
+    int8_t roms[num_roms];
 
-    static const int buf_size = 1024 * 1024;
-    int cur_pos = 0;
-    static uint8_t buffer[buf_size];
+    // copied images are packed into chunks which are allocated on demand
+    static const int chunk_size = 256 * 1024;
+    static const int max_chunks = 16;
+    uint8_t* chunks[max_chunks] = { };
+    int num_chunks = 0;
+    int chunk_pos = chunk_size;
+    bool locked = false;
 };
 extern rom_images roms;
 
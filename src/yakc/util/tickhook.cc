@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+//  tickhook.cc
+//------------------------------------------------------------------------------
+#include "tickhook.h"
+#include "yakc/util/breadboard.h"
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+bool
+tickhook::add(observer_func fn, void* user_data) {
+    YAKC_ASSERT(fn);
+    if (this->num_observers >= max_observers) {
+        return false;
+    }
+    this->observers[this->num_observers].fn = fn;
+    this->observers[this->num_observers].user_data = user_data;
+    this->num_observers++;
+    this->update();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+tickhook::remove(observer_func fn, void* user_data) {
+    for (int i = 0; i < this->num_observers; i++) {
+        if ((this->observers[i].fn == fn) && (this->observers[i].user_data == user_data)) {
+            for (int j = i; j < (this->num_observers - 1); j++) {
+                this->observers[j] = this->observers[j+1];
+            }
+            this->num_observers--;
+            this->observers[this->num_observers] = observer();
+            break;
+        }
+    }
+    this->update();
+}
+
+//------------------------------------------------------------------------------
+void
+tickhook::set_input(input_func fn, void* user_data) {
+    this->input_fn = fn;
+    this->input_user_data = fn ? user_data : nullptr;
+    this->update();
+}
+
+//------------------------------------------------------------------------------
+void
+tickhook::update() {
+    const bool hook = (this->num_observers > 0) || (nullptr != this->input_fn);
+    if (board.z80) {
+        z80_t* cpu = board.z80;
+        if (hook && (cpu->tick_cb != z80_tick)) {
+            this->z80_orig_tick = cpu->tick_cb;
+            this->orig_user_data = cpu->user_data;
+            cpu->tick_cb = z80_tick;
+            cpu->user_data = this;
+        }
+        else if (!hook && (cpu->tick_cb == z80_tick)) {
+            cpu->tick_cb = this->z80_orig_tick;
+            cpu->user_data = this->orig_user_data;
+        }
+    }
+    else if (board.m6502) {
+        m6502_t* cpu = board.m6502;
+        if (hook && (cpu->tick_cb != m6502_tick)) {
+            this->m6502_orig_tick = cpu->tick_cb;
+            this->orig_user_data = cpu->user_data;
+            cpu->tick_cb = m6502_tick;
+            cpu->user_data = this;
+        }
+        else if (!hook && (cpu->tick_cb == m6502_tick)) {
+            cpu->tick_cb = this->m6502_orig_tick;
+            cpu->user_data = this->orig_user_data;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+tickhook::reset() {
+    this->z80_orig_tick = nullptr;
+    this->m6502_orig_tick = nullptr;
+    this->orig_user_data = nullptr;
+    this->input_fn = nullptr;
+    this->input_user_data = nullptr;
+}
+
+} // namespace YAKC
@@ -0,0 +1,94 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::tickhook
+    @brief observe CPU tick callbacks without modifying the system emulators
+
+    The tickhook patches the tick callback of the currently active CPU
+    with a trampoline function which first calls the original system
+    tick callback, and then forwards the CPU pins to all registered
+    observers (e.g. for reverse debugging, or memory access statistics).
+
+    Additionally, a single input callback can be installed which may
+    modify the pins returned to the CPU, this is used to feed external
+    signals (like a tape recorder) into the emulated system.
+
+    If no observers and no input callback are registered, the original
+    tick callback is restored, so that there's no runtime overhead at all.
+
+    NOTE: the tickhook must be updated after each poweron and after
+    a machine state snapshot has been restored, since both will
+    overwrite the CPU tick callback.
+*/
+#include "yakc/util/core.h"
+#include "chips/z80.h"
+#include "chips/m6502.h"
+
+namespace YAKC {
+
+class tickhook {
+public:
+    /// an observer callback, called after each CPU tick callback
+    typedef void (*observer_func)(int num_ticks, uint64_t pins, void* user_data);
+    /// an input callback, may modify the pins returned to the CPU
+    typedef uint64_t (*input_func)(int num_ticks, uint64_t pins, void* user_data);
+    /// max number of observers
+    static const int max_observers = 6;
+
+    /// add an observer, return false if no free observer slot
+    bool add(observer_func fn, void* user_data);
+    /// remove an observer
+    void remove(observer_func fn, void* user_data);
+    /// set or clear (with nullptr) the input callback
+    void set_input(input_func fn, void* user_data);
+    /// patch or unpatch the current CPU's tick callback
+    void update();
+    /// forget the patched CPU (called when system is switched off)
+    void reset();
+
+private:
+    static uint64_t z80_tick(int num_ticks, uint64_t pins, void* user_data);
+    static uint64_t m6502_tick(uint64_t pins, void* user_data);
+
+    struct observer {
+        observer_func fn = nullptr;
+        void* user_data = nullptr;
+    } observers[max_observers];
+    int num_observers = 0;
+    input_func input_fn = nullptr;
+    void* input_user_data = nullptr;
+
+    z80_tick_t z80_orig_tick = nullptr;
+    m6502_tick_t m6502_orig_tick = nullptr;
+    void* orig_user_data = nullptr;
+};
+
+//------------------------------------------------------------------------------
+inline uint64_t
+tickhook::z80_tick(int num_ticks, uint64_t pins, void* user_data) {
+    tickhook* self = (tickhook*) user_data;
+    pins = self->z80_orig_tick(num_ticks, pins, self->orig_user_data);
+    if (self->input_fn) {
+        pins = self->input_fn(num_ticks, pins, self->input_user_data);
+    }
+    for (int i = 0; i < self->num_observers; i++) {
+        self->observers[i].fn(num_ticks, pins, self->observers[i].user_data);
+    }
+    return pins;
+}
+
+//------------------------------------------------------------------------------
+inline uint64_t
+tickhook::m6502_tick(uint64_t pins, void* user_data) {
+    tickhook* self = (tickhook*) user_data;
+    pins = self->m6502_orig_tick(pins, self->orig_user_data);
+    if (self->input_fn) {
+        pins = self->input_fn(1, pins, self->input_user_data);
+    }
+    for (int i = 0; i < self->num_observers; i++) {
+        self->observers[i].fn(1, pins, self->observers[i].user_data);
+    }
+    return pins;
+}
+
+} // namespace YAKC
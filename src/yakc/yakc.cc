@@ -10,49 +10,180 @@
 #include "emus/cpc.h"
 #include "emus/c64.h"
 #include <stdio.h>
+#include <string.h>
+#include <chrono>
 
 namespace YAKC {
 
+namespace {
+
+// optional system functions, with a fallback for systems which don't have them
+template<class T> auto opt_on_joystick(T* s, uint8_t mask, int) -> decltype(s->on_joystick(mask)) {
+    s->on_joystick(mask);
+}
+template<class T> void opt_on_joystick(T*, uint8_t, long) { }
+template<class T> auto opt_decode_audio(T* s, float* buf, int num, int) -> decltype(s->decode_audio(buf, num)) {
+    s->decode_audio(buf, num);
+}
+template<class T> void opt_decode_audio(T*, float* buf, int num, long) {
+    clear(buf, num * sizeof(float));
+}
+template<class T> auto opt_tape_motor_on(T* s, int) -> decltype(s->tape_motor_on()) {
+    return s->tape_motor_on();
+}
+template<class T> bool opt_tape_motor_on(T*, long) {
+    return false;
+}
+template<class T> auto opt_paste_char(T* s, uint8_t ascii, int) -> decltype(s->paste_char(ascii)) {
+    return s->paste_char(ascii);
+}
+template<class T> paste_result opt_paste_char(T*, uint8_t, long) {
+    return paste_result::unsupported;
+}
+template<class T> auto opt_advance_timers(T* s, uint32_t us, int) -> decltype(s->advance_timers(us)) {
+    s->advance_timers(us);
+}
+template<class T> void opt_advance_timers(T*, uint32_t, long) { }
+template<class T> auto opt_has_advance_timers(T* s, int) -> decltype(s->advance_timers(0), true) {
+    return true;
+}
+template<class T> bool opt_has_advance_timers(T*, long) {
+    return false;
+}
+
+// the function table for a system emulator singleton
+template<class T, T* S> struct dispatch {
+    static void poweroff() { S->poweroff(); }
+    static void reset() { S->reset(); }
+    static void exec(uint32_t us) { S->exec(us); }
+    static void on_ascii(uint8_t ascii) { S->on_ascii(ascii); }
+    static void on_key_down(uint8_t key) { S->on_key_down(key); }
+    static void on_key_up(uint8_t key) { S->on_key_up(key); }
+    static void on_joystick(uint8_t mask) { opt_on_joystick(S, mask, 0); }
+    static const void* framebuffer(int& w, int& h) { return S->framebuffer(w, h); }
+    static void decode_audio(float* buf, int num) { opt_decode_audio(S, buf, num, 0); }
+    static bool quickload(filesystem* fs, const char* name, filetype type, bool start) {
+        return S->quickload(fs, name, type, start);
+    }
+    static const char* system_info() { return S->system_info(); }
+    static int num_joysticks() { return S->num_joysticks(); }
+    static bool tape_motor_on() { return opt_tape_motor_on(S, 0); }
+    static paste_result paste_char(uint8_t ascii) { return opt_paste_char(S, ascii, 0); }
+    static void advance_timers(uint32_t us) { opt_advance_timers(S, us, 0); }
+
+    static sysfuncs funcs() {
+        sysfuncs f;
+        f.poweroff = poweroff;
+        f.reset = reset;
+        f.exec = exec;
+        f.on_ascii = on_ascii;
+        f.on_key_down = on_key_down;
+        f.on_key_up = on_key_up;
+        f.on_joystick = on_joystick;
+        f.framebuffer = framebuffer;
+        f.decode_audio = decode_audio;
+        f.quickload = quickload;
+        f.system_info = system_info;
+        f.num_joysticks = num_joysticks;
+        f.tape_motor_on = tape_motor_on;
+        f.paste_char = paste_char;
+        // systems without advance_timers() don't skip idle frames
+        f.advance_timers = opt_has_advance_timers(S, 0) ? advance_timers : nullptr;
+        f.decode_io = T::decode_io;
+        return f;
+    }
+};
+
+// placeholder while no system is switched on
+struct none_t {
+    void poweroff() { }
+    void reset() { }
+    void exec(uint32_t) { }
+    void on_ascii(uint8_t) { }
+    void on_key_down(uint8_t) { }
+    void on_key_up(uint8_t) { }
+    const void* framebuffer(int& out_width, int& out_height) {
+        out_width = 0;
+        out_height = 0;
+        return nullptr;
+    }
+    bool quickload(filesystem*, const char*, filetype, bool) { return false; }
+    const char* system_info() const { return "no info available"; }
+    int num_joysticks() const { return 0; }
+    static void decode_io(uint64_t, bool, iostats&) { }
+};
+none_t no_system;
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+yakc::yakc() {
+    this->sys = dispatch<none_t, &no_system>::funcs();
+}
+
 //------------------------------------------------------------------------------
 void
-yakc::init(const ext_funcs& sys_funcs) {
+yakc::init(const ext_funcs& sys_funcs, int fs_store_size) {
     func = sys_funcs;
-    fill_random(board.random, sizeof(board.random));
+    this->filesystem.init(fs_store_size);
 }
 
 //------------------------------------------------------------------------------
 void
+yakc::discard() {
+    this->poweroff();
+    this->rewinder.disable();
+    this->bootcache.clear();
+    this->memstats.discard();
+    this->iostats.discard();
+    this->coverage.discard();
+    this->idle.disable();
+    this->filesystem.discard();
+    board.free_rgba8_buffer();
+}
+
+//------------------------------------------------------------------------------
+memory_report
+yakc::memory_usage() const {
+    memory_report r;
+    r.sys_state = board.sys_state_size;
+    r.pixel_buffer = board.rgba8_alloc_size;
+    r.rom_images = roms.num_bytes();
+    r.filesystem = this->filesystem.store_size();
+    r.rewinder = this->rewinder.num_bytes();
+    r.bootcache = this->bootcache.num_bytes();
+    r.memstats = this->memstats.num_bytes();
+    r.iostats = this->iostats.num_bytes();
+    r.coverage = this->coverage.num_bytes();
+    r.idle = this->idle.num_bytes();
+    r.total = r.sys_state + r.pixel_buffer + r.rom_images + r.filesystem + r.rewinder + r.bootcache +
+              r.memstats + r.iostats + r.coverage + r.idle;
+    return r;
+}
+
+//------------------------------------------------------------------------------
+bool
 yakc::add_rom(rom_images::rom type, const uint8_t* ptr, int size) {
-    roms.add(type, ptr, size);
+    return roms.add(type, ptr, size);
+}
+
+//------------------------------------------------------------------------------
+bool
+yakc::add_rom_ref(rom_images::rom type, const uint8_t* ptr, int size) {
+    return roms.add_ref(type, ptr, size);
 }
 
 //------------------------------------------------------------------------------
 bool
 yakc::check_roms(system m, os_rom os) {
-    if (is_system(m, system::any_z1013)) {
-        return z1013_t::check_roms(m);
-    }
-    else if (is_system(m, system::any_z9001)) {
-        return z9001_t::check_roms(m);
-    }
-    else if (is_system(m, system::any_zx)) {
-        return zx_t::check_roms(m);
-    }
-    else if (is_system(m, system::any_kc85)) {
-        return kc85_t::check_roms(m, os);
-    }
-    else if (is_system(m, system::acorn_atom)) {
-        return atom_t::check_roms(m);
-    }
-    else if (is_system(m, system::any_cpc)) {
-        return cpc_t::check_roms(m);
-    }
-    else if (is_system(m, system::any_c64)) {
-        return c64_t::check_roms(m);
-    }
-    else {
-        return false;
+    rom_images::rom required[rom_images::max_required];
+    const int num = rom_images::required(m, os, required, rom_images::max_required);
+    for (int i = 0; i < num; i++) {
+        if (!roms.has(required[i])) {
+            return false;
+        }
     }
+    return num > 0;
 }
 
 //------------------------------------------------------------------------------
@@ -63,6 +194,7 @@ yakc::poweron(system m, os_rom rom) {
     this->enable_joystick(false);
     this->accel = 1;
     board.dbg.init(this->cpu_type());
+    const uint32_t* prev_pixels = board.rgba8_alloc;
     if (this->is_system(system::any_z1013)) {
         z1013.poweron(m);
     }
@@ -84,65 +216,81 @@ yakc::poweron(system m, os_rom rom) {
     else if (this->is_system(system::any_c64)) {
         c64.poweron(m);
     }
+    // the cached boot states point into the pixel buffer, which is
+    // reallocated when a system with a different display size is switched on
+    if (board.rgba8_alloc != prev_pixels) {
+        this->bootcache.clear();
+    }
+    this->select_system();
+    board.tickhook.update();
+    this->setup_idle();
+    this->setup_iostats();
+    this->setup_coverage();
+    if (this->rewinder.is_enabled()) {
+        this->rewinder.enable(this->snapshot_size());
+    }
+    // the OS boot is deferred to the first frame, so that expansion
+    // modules can be inserted before
+    this->boot_pending = true;
+    this->boot_record_us = 0;
+    this->frame_time_us = 0;
+    this->frame_begin = true;
 }
 
 //------------------------------------------------------------------------------
 void
 yakc::poweroff() {
+    this->boot_pending = false;
+    this->boot_record_us = 0;
+    this->coverage.detach();
+    this->paste.stop();
+    this->sys.poweroff();
+    this->select_system();
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::select_system() {
     if (z1013.on) {
-        z1013.poweroff();
+        this->sys = dispatch<z1013_t, &z1013>::funcs();
     }
-    if (z9001.on) {
-        z9001.poweroff();
+    else if (z9001.on) {
+        this->sys = dispatch<z9001_t, &z9001>::funcs();
     }
-    if (zx.on) {
-        zx.poweroff();
+    else if (zx.on) {
+        this->sys = dispatch<zx_t, &zx>::funcs();
     }
-    if (kc85.on) {
-        kc85.poweroff();
+    else if (kc85.on) {
+        this->sys = dispatch<kc85_t, &kc85>::funcs();
     }
-    if (atom.on) {
-        atom.poweroff();
+    else if (atom.on) {
+        this->sys = dispatch<atom_t, &atom>::funcs();
     }
-    if (cpc.on) {
-        cpc.poweroff();
+    else if (cpc.on) {
+        this->sys = dispatch<cpc_t, &cpc>::funcs();
     }
-    if (c64.on) {
-        c64.poweroff();
+    else if (c64.on) {
+        this->sys = dispatch<c64_t, &c64>::funcs();
+    }
+    else {
+        this->sys = dispatch<none_t, &no_system>::funcs();
     }
 }
 
 //------------------------------------------------------------------------------
 bool
 yakc::switchedon() const {
-    return z1013.on || z9001.on | zx.on | kc85.on | atom.on | cpc.on | c64.on;
+    return this->sys.exec != dispatch<none_t, &no_system>::exec;
 }
 
 //------------------------------------------------------------------------------
 void
 yakc::reset() {
+    this->boot_record_us = 0;
+    this->input_hold_us = input_hold_length_us;
     this->enable_joystick(false);
-    if (z1013.on) {
-        z1013.reset();
-    }
-    if (z9001.on) {
-        z9001.reset();
-    }
-    if (zx.on) {
-        zx.reset();
-    }
-    if (kc85.on) {
-        kc85.reset();
-    }
-    if (atom.on) {
-        atom.reset();
-    }
-    if (cpc.on) {
-        cpc.reset();
-    }
-    if (c64.on) {
-        c64.reset();
-    }
+    this->idle.wake();
+    this->sys.reset();
 }
 
 //------------------------------------------------------------------------------
@@ -172,51 +320,332 @@ yakc::cpu_type() const {
 void
 yakc::exec(int micro_secs) {
     YAKC_ASSERT(this->accel > 0);
+    YAKC_PROFILE_FRAME();
     if (!board.dbg.break_stopped()) {
-        if (z1013.on) {
-            z1013.exec(micro_secs);
+        this->boot();
+        // skip frames while the system is idle, only on systems which
+        // can advance their OS clocks in RAM while frames are skipped
+        if (this->paste.is_active() || this->warp_active() || this->tape_motor_on()) {
+            this->idle.wake();
         }
-        else if (z9001.on) {
-            z9001.exec(micro_secs);
+        else if (this->sys.advance_timers && this->idle.can_skip()) {
+            this->advance_timers(micro_secs);
+            this->idle.on_skip(micro_secs);
+            return;
         }
-        else if (zx.on) {
-            zx.exec(micro_secs);
+        this->exec_system(micro_secs);
+
+        // check if breakpoint has been hit
+        board.dbg.break_check();
+
+        // run as fast as possible while the tape or disc motor is on
+        if (!board.dbg.break_stopped() && this->warp_active()) {
+            this->warp(micro_secs);
         }
-        else if (kc85.on) {
-            kc85.exec(micro_secs);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::exec_system(int micro_secs) {
+    {
+        YAKC_PROFILE_SCOPE(input);
+        this->paste.update(*this, micro_secs);
+    }
+    // the rewinder snapshot includes the input, so that a replay
+    // never needs to cross a machine state change between calls
+    if (this->rewinder.is_enabled() && (this->frame_begin || this->input_pending())) {
+        this->rewinder.on_frame(*this);
+    }
+    this->frame_begin = false;
+    this->exec_current_system(micro_secs);
+    this->iostats.on_frame(micro_secs);
+    if (this->boot_record_us > 0) {
+        this->record_boot(micro_secs);
+    }
+    if (this->input_hold_us > 0) {
+        this->input_hold_us -= micro_secs;
+    }
+    // per-frame work happens on emulated frame boundaries, independent
+    // from the length of the time slices exec() is called with
+    this->frame_time_us += micro_secs;
+    if (this->frame_time_us >= frame_length_us) {
+        this->frame_time_us %= frame_length_us;
+        this->frame_begin = true;
+        this->idle.on_frame();
+        if (this->memstats.is_enabled()) {
+            this->memstats.decay();
         }
-        else if (atom.on) {
-            atom.exec(micro_secs);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+yakc::input_pending() const {
+    // the system emulators process key releases at the end of each
+    // exec call, and tape data may be loaded between calls
+    return (this->input_hold_us > 0) || this->paste.is_active() || this->tape_motor_on();
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::exec_current_system(int micro_secs) {
+    this->sys.exec(micro_secs);
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::warp(int micro_secs) {
+    // run additional frames until the time budget is used up,
+    // audio output is muted since it would overflow the audio buffer
+    const auto start = std::chrono::steady_clock::now();
+    int64_t elapsed_us = 0;
+    int64_t emulated_us = 0;
+    board.mute_audio = true;
+    for (int i = 0; i < max_warp_frames; i++) {
+        this->exec_system(micro_secs);
+        emulated_us += micro_secs;
+        board.dbg.break_check();
+        elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        if (board.dbg.break_stopped() || !this->warp_active() || (elapsed_us >= this->warp_budget_us)) {
+            break;
         }
-        else if (cpc.on) {
-            cpc.exec(micro_secs);
+    }
+    board.mute_audio = false;
+    if (emulated_us > elapsed_us) {
+        this->warp_saved_us += emulated_us - elapsed_us;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+yakc::warp_active() const {
+    if (this->is_auto_warp_enabled(this->model) && this->tape_motor_on()) {
+        return true;
+    }
+    if (this->fast_paste && this->paste.is_active()) {
+        return true;
+    }
+    return this->fast_disc && this->disc_motor_on();
+}
+
+//------------------------------------------------------------------------------
+int
+yakc::boot_time_us() const {
+    // time until the OS waits for keyboard input after a cold boot
+    if (this->is_system(system::any_c64)) {
+        return 3000000;     // BASIC RAM check
+    }
+    else if (this->is_system(system::any_zx) || this->is_system(system::any_cpc)) {
+        return 2000000;
+    }
+    else if (this->is_system(system::any_kc85) || this->is_system(system::any_z9001)) {
+        return 1000000;
+    }
+    else {
+        return 500000;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::boot() {
+    if (!this->boot_pending) {
+        return;
+    }
+    this->boot_pending = false;
+    if (!this->bootcache.enabled || board.dbg.breakpoint_enabled()) {
+        // the OS boots in real time during the first frames
+        return;
+    }
+    this->boot_key = this->boot_cache_key();
+    const uint8_t* snapshot = this->bootcache.find(this->boot_key, this->snapshot_size());
+    if (snapshot) {
+        this->load_snapshot(snapshot);
+        this->bootcache.hits++;
+        this->idle.wake();
+        if (this->rewinder.is_enabled()) {
+            this->rewinder.clear();
         }
-        else if (c64.on) {
-            c64.exec(micro_secs);
+    }
+    else {
+        // boot in real time, the machine state is cached in record_boot()
+        // when the boot time has passed without input
+        this->boot_record_us = this->boot_time_us();
+        this->bootcache.misses++;
+    }
+}
+
+//------------------------------------------------------------------------------
+uint64_t
+yakc::boot_cache_key() const {
+    // the machine state contains host pointers, so only pointer-free
+    // data goes into the key: the CRC of each 256-byte page of the
+    // CPU-visible memory, and the inserted KC85 expansion modules
+    uint32_t config[256 + KC85_NUM_SLOTS] = { };
+    int num = 0;
+    uint8_t page[256];
+    for (int p = 0; p < 256; p++) {
+        for (int i = 0; i < 256; i++) {
+            page[i] = mem_rd(board.mem, uint16_t((p<<8)|i));
         }
-        else {
-            //this->abs_cycle_count = abs_end_cycles;
+        config[num++] = rom_images::crc32(page, sizeof(page));
+    }
+    if (kc85.on) {
+        for (int i = 0; i < KC85_NUM_SLOTS; i++) {
+            const auto& slot = kc85.sys.exp.slot[i];
+            config[num++] = (uint32_t(slot.addr)<<8) | uint32_t(slot.mod.type);
         }
+    }
+    return bootcache::key(this->model, this->os, config, num);
+}
 
-        // check if breakpoint has been hit
-        board.dbg.break_check();
+//------------------------------------------------------------------------------
+void
+yakc::record_boot(int micro_secs) {
+    // pasted text changes the booted state
+    if (this->paste.is_active()) {
+        this->boot_record_us = 0;
+        return;
+    }
+    this->boot_record_us -= micro_secs;
+    if (this->boot_record_us <= 0) {
+        this->bootcache.add(this->boot_key, board.sys_state, this->snapshot_size());
+        this->boot_record_us = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::setup_idle() {
+    // RAM timers which are updated by interrupt handlers on idle systems
+    this->idle.clear_excludes();
+    if (c64.on) {
+        this->idle.exclude(c64_t::timer_addr, c64_t::timer_size);
+    }
+    else if (zx.on) {
+        this->idle.exclude(zx_t::timer_addr, zx_t::timer_size);
+    }
+    this->idle.wake();
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::setup_iostats() {
+    // CPC I/O ports are decoded by the upper address byte
+    this->iostats.set_decoder(this->sys.decode_io, cpc.on ? 8 : 0);
+    this->iostats.clear();
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::setup_coverage() {
+    // the ROM images of the system, and on KC85 the ROM images of the
+    // registered expansion modules (identified by the pointer the
+    // module registry was given, not by content)
+    rom_images::rom mapped[coverage::max_mapped_roms];
+    int num_mapped = rom_images::required(this->model, this->os, mapped, rom_images::max_required);
+    if (kc85.on) {
+        for (int type = 0; type < KC85_MODULE_NUM; type++) {
+            const auto& mod = kc85.mod_registry[type];
+            if (!mod.registered || !mod.mem_ptr) {
+                continue;
+            }
+            for (int i = 0; (i < rom_images::num_roms) && (num_mapped < coverage::max_mapped_roms); i++) {
+                const rom_images::rom rom = (rom_images::rom) i;
+                if (roms.has(rom) && (roms.ptr(rom) == mod.mem_ptr)) {
+                    mapped[num_mapped++] = rom;
+                    break;
+                }
+            }
+        }
+    }
+    this->coverage.set_roms(mapped, num_mapped);
+    if (this->coverage.is_enabled()) {
+        this->coverage.attach();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::advance_timers(int micro_secs) {
+    this->sys.advance_timers(micro_secs);
+
+    // keep the audio stream running with the last sample value, so that
+    // the audio output neither runs dry nor clicks while frames are skipped
+    if (!board.mute_audio) {
+        this->skip_audio_us += micro_secs;
+        const int num_samples = int((int64_t(this->skip_audio_us) * board.audio_sample_rate) / 1000000);
+        this->skip_audio_us -= int((int64_t(num_samples) * 1000000) / board.audio_sample_rate);
+        const float sample = board.audiobuffer.last_sample;
+        for (int i = 0; i < num_samples; i++) {
+            board.audiobuffer.write(sample);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+yakc::disc_motor_on() const {
+    if (cpc.on) {
+        return cpc.disc_motor_on();
+    }
+    else {
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+yakc::tape_motor_on() const {
+    return this->sys.tape_motor_on();
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::enable_auto_warp(system m, bool b) {
+    if (b) {
+        this->auto_warp = system(int(this->auto_warp) | int(m));
+    }
+    else {
+        this->auto_warp = system(int(this->auto_warp) & ~int(m));
     }
 }
 
+//------------------------------------------------------------------------------
+bool
+yakc::is_auto_warp_enabled(system m) const {
+    return 0 != (int(this->auto_warp) & int(m));
+}
+
 //------------------------------------------------------------------------------
 uint32_t
 yakc::step() {
+    // stepping right after poweron debugs the real OS boot
+    this->boot_pending = false;
+    this->boot_record_us = 0;
+    const uint32_t ticks = this->replay_step();
+    if (board.z80) {
+        board.dbg.add_history_item(z80_pc(board.z80), ticks);
+    }
+    else if (board.m6502) {
+        board.dbg.add_history_item(board.m6502->state.PC, ticks);
+    }
+    return ticks;
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+yakc::replay_step() {
     uint32_t ticks = 0;
     if (board.z80) {
         ticks = z80_exec(board.z80, 0);
         if (!z80_opdone(board.z80)) {
             ticks += z80_exec(board.z80, 0);
         }
-        board.dbg.add_history_item(z80_pc(board.z80), ticks);
     }
     else if (board.m6502) {
         ticks = m6502_exec(board.m6502, 0);
-        board.dbg.add_history_item(board.m6502->state.PC, ticks);
     }
     return ticks;
 }
@@ -232,103 +661,116 @@ yakc::step_until(std::function<bool(uint32_t)> fn) {
     return ticks;
 }
 
+//------------------------------------------------------------------------------
+int
+yakc::snapshot_size() const {
+    return board.sys_state_size;
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::save_snapshot(void* ptr) const {
+    YAKC_ASSERT(ptr && board.sys_state);
+    memcpy(ptr, board.sys_state, board.sys_state_size);
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::load_snapshot(const void* ptr) {
+    YAKC_ASSERT(ptr && board.sys_state);
+    memcpy(board.sys_state, ptr, board.sys_state_size);
+    this->boot_record_us = 0;
+    // the snapshot may contain an unpatched CPU tick callback
+    board.tickhook.update();
+}
+
+//------------------------------------------------------------------------------
+fork_state
+yakc::fork() const {
+    fork_state state;
+    this->save_fork(state);
+    return state;
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::load_fork(const fork_state& state) {
+    YAKC_ASSERT(board.sys_state && (state.size() == board.sys_state_size));
+    state.restore((uint8_t*)board.sys_state);
+    this->boot_record_us = 0;
+    board.tickhook.update();
+}
+
+//------------------------------------------------------------------------------
+void
+yakc::save_fork(fork_state& state) const {
+    YAKC_ASSERT(board.sys_state);
+    state.save((const uint8_t*)board.sys_state, board.sys_state_size);
+}
+
+//------------------------------------------------------------------------------
+bool
+yakc::step_back() {
+    return this->rewinder.step_back(*this);
+}
+
+//------------------------------------------------------------------------------
+bool
+yakc::run_back_to(uint16_t addr) {
+    return this->rewinder.run_back_to(*this, addr);
+}
+
+//------------------------------------------------------------------------------
+bool
+yakc::reverse_continue() {
+    return this->rewinder.reverse_continue(*this);
+}
+
 //------------------------------------------------------------------------------
 void
 yakc::on_ascii(uint8_t ascii) {
-    if (z1013.on) {
-        z1013.on_ascii(ascii);
-    }
-    if (z9001.on) {
-        z9001.on_ascii(ascii);
-    }
-    if (zx.on) {
-        zx.on_ascii(ascii);
-    }
-    if (kc85.on) {
-        kc85.on_ascii(ascii);
-    }
-    if (atom.on) {
-        atom.on_ascii(ascii);
-    }
-    if (cpc.on) {
-        cpc.on_ascii(ascii);
-    }
-    if (c64.on) {
-        c64.on_ascii(ascii);
-    }
+    YAKC_PROFILE_SCOPE(input);
+    this->idle.wake();
+    this->boot_record_us = 0;
+    this->input_hold_us = input_hold_length_us;
+    this->sys.on_ascii(ascii);
 }
 
 //------------------------------------------------------------------------------
 void
 yakc::on_key_down(uint8_t key) {
-    if (z1013.on) {
-        z1013.on_key_down(key);
-    }
-    if (z9001.on) {
-        z9001.on_key_down(key);
-    }
-    if (zx.on) {
-        zx.on_key_down(key);
-    }
-    if (kc85.on) {
-        kc85.on_key_down(key);
-    }
-    if (atom.on) {
-        atom.on_key_down(key);
-    }
-    if (cpc.on) {
-        cpc.on_key_down(key);
-    }
-    if (c64.on) {
-        c64.on_key_down(key);
-    }
+    YAKC_PROFILE_SCOPE(input);
+    this->idle.wake();
+    this->boot_record_us = 0;
+    this->input_hold_us = input_hold_length_us;
+    this->sys.on_key_down(key);
 }
 
 //------------------------------------------------------------------------------
 void
 yakc::on_key_up(uint8_t key) {
-    if (z1013.on) {
-        z1013.on_key_up(key);
-    }
-    if (z9001.on) {
-        z9001.on_key_up(key);
-    }
-    if (zx.on) {
-        zx.on_key_up(key);
-    }
-    if (kc85.on) {
-        kc85.on_key_up(key);
-    }
-    if (atom.on) {
-        atom.on_key_up(key);
-    }
-    if (cpc.on) {
-        cpc.on_key_up(key);
-    }
-    if (c64.on) {
-        c64.on_key_up(key);
-    }
+    YAKC_PROFILE_SCOPE(input);
+    this->idle.wake();
+    this->boot_record_us = 0;
+    this->input_hold_us = input_hold_length_us;
+    this->sys.on_key_up(key);
 }
 
 //------------------------------------------------------------------------------
 void
 yakc::on_joystick(uint8_t joy0_kbd_mask, uint8_t joy0_pad_mask) {
+    YAKC_PROFILE_SCOPE(input);
     if (!this->joystick_enabled) {
         joy0_kbd_mask = 0;
     }
     const uint8_t joy0_mask = joy0_kbd_mask|joy0_pad_mask;
-    if (zx.on) {
-        zx.on_joystick(joy0_mask);
-    }
-    if (atom.on) {
-        atom.on_joystick(joy0_mask);
-    }
-    if (cpc.on) {
-        cpc.on_joystick(joy0_mask);
-    }
-    if (c64.on) {
-        c64.on_joystick(joy0_mask);
+    if (joy0_mask != this->joystick_mask) {
+        this->joystick_mask = joy0_mask;
+        this->idle.wake();
+        this->boot_record_us = 0;
+        this->input_hold_us = input_hold_length_us;
     }
+    this->sys.on_joystick(joy0_mask);
 }
 
 //------------------------------------------------------------------------------
@@ -346,117 +788,31 @@ yakc::is_joystick_enabled() const {
 //------------------------------------------------------------------------------
 int
 yakc::num_joysticks() const {
-    if (z1013.on) {
-        return z1013.num_joysticks();
-    }
-    else if (z9001.on) {
-        return z9001.num_joysticks();
-    }
-    else if (zx.on) {
-        return zx.num_joysticks();
-    }
-    else if (kc85.on) {
-        return kc85.num_joysticks();
-    }
-    else if (atom.on) {
-        return atom.num_joysticks();
-    }
-    else if (cpc.on) {
-        return cpc.num_joysticks();
-    }
-    else if (c64.on) {
-        return c64.num_joysticks();
-    }
-    else {
-        return 0;
-    }
+    return this->sys.num_joysticks();
 }
 
 //------------------------------------------------------------------------------
 const char*
 yakc::system_info() const {
-    if (z1013.on) {
-        return z1013.system_info();
-    }
-    else if (z9001.on) {
-        return z9001.system_info();
-    }
-    else if (zx.on) {
-        return zx.system_info();
-    }
-    else if (kc85.on) {
-        return kc85.system_info();
-    }
-    else if (atom.on) {
-        return atom.system_info();
-    }
-    else if (cpc.on) {
-        return cpc.system_info();
-    }
-    else if (c64.on) {
-        return c64.system_info();
-    }
-    else {
-        return "no info available";
-    }
+    return this->sys.system_info();
 }
 
 //------------------------------------------------------------------------------
 void
 yakc::fill_sound_samples(float* buffer, int num_samples) {
     if (!board.dbg.break_stopped()) {
-        if (z9001.on) {
-            return z9001.decode_audio(buffer, num_samples);
-        }
-        else if (zx.on) {
-            return zx.decode_audio(buffer, num_samples);
-        }
-        if (kc85.on) {
-            return kc85.decode_audio(buffer, num_samples);
-        }
-        else if (atom.on) {
-            return atom.decode_audio(buffer, num_samples);
-        }
-        else if (cpc.on) {
-            return cpc.decode_audio(buffer, num_samples);
-        }
-        else if (c64.on) {
-            return c64.decode_audio(buffer, num_samples);
-        }
+        this->sys.decode_audio(buffer, num_samples);
+    }
+    else {
+        // debugging active: return silence
+        clear(buffer, num_samples * sizeof(float));
     }
-    // fallthrough: all systems off, or debugging active: return silence
-    clear(buffer, num_samples * sizeof(float));
 }
 
 //------------------------------------------------------------------------------
 const void*
 yakc::framebuffer(int& out_width, int& out_height) {
-    if (z1013.on) {
-        return z1013.framebuffer(out_width, out_height);
-    }
-    else if (z9001.on) {
-        return z9001.framebuffer(out_width, out_height);
-    }
-    else if (zx.on) {
-        return zx.framebuffer(out_width, out_height);
-    }
-    else if (kc85.on) {
-        return kc85.framebuffer(out_width, out_height);
-    }
-    else if (atom.on) {
-        return atom.framebuffer(out_width, out_height);
-    }
-    else if (cpc.on) {
-        return cpc.framebuffer(out_width, out_height);
-    }
-    else if (c64.on) {
-        return c64.framebuffer(out_width, out_height);
-    }
-    else {
-        out_width = 0;
-        out_height = 0;
-        return nullptr;
-    }
+    return this->sys.framebuffer(out_width, out_height);
 }
 
 //------------------------------------------------------------------------------
@@ -471,40 +827,43 @@ yakc::load_tape_cmd() {
     else if (c64.on) {
         return "LOAD\n";
     }
+    else if (zx.on) {
+        // 48K: LOAD "" (the J key produces the LOAD keyword),
+        // 128K: the first menu entry is the tape loader
+        return zx.cur_model == system::zxspectrum48k ? "j\"\"\n" : "\n";
+    }
     else {
         return nullptr;
     }
 }
 
 //------------------------------------------------------------------------------
-bool
-yakc::quickload(const char* name, filetype type, bool start) {
-    bool retval = false;
-    if (z1013.on) {
-        retval = z1013.quickload(&this->filesystem, name, type, start);
-    }
-    else if (z9001.on) {
-        retval = z9001.quickload(&this->filesystem, name, type, start);
-    }
-    else if (zx.on) {
-        retval = zx.quickload(&this->filesystem, name, type, start);
-    }
-    else if (kc85.on) {
-        retval = kc85.quickload(&this->filesystem, name, type, start);
-    }
-    else if (cpc.on) {
-        retval = cpc.quickload(&this->filesystem, name, type, start);
-    }
-    else if (c64.on) {
-        retval = c64.quickload(&this->filesystem, name, type, start);
-    }
-    else if (atom.on) {
-        retval = atom.quickload(&this->filesystem, name, type, start);
+const char*
+yakc::disc_boot_cmd() {
+    if (cpc.on) {
+        return cpc.disc_boot_cmd();
     }
     else {
-        retval = false;
+        return nullptr;
     }
-    return retval;
+}
+
+//------------------------------------------------------------------------------
+paste_result
+yakc::paste_char(uint8_t ascii) {
+    return this->sys.paste_char(ascii);
+}
+
+//------------------------------------------------------------------------------
+bool
+yakc::quickload(const char* name, filetype type, bool start) {
+    this->boot();
+    this->idle.wake();
+    this->boot_record_us = 0;
+    this->input_hold_us = input_hold_length_us;
+    zx.fast_tape = this->fast_tape;
+    c64.fast_tape = this->fast_tape;
+    return this->sys.quickload(&this->filesystem, name, type, start);
 }
 
 } // namespace YAKC
@@ -8,16 +8,67 @@
 #include "yakc/util/core.h"
 #include "yakc/util/filesystem.h"
 #include "yakc/util/filetypes.h"
+#include "yakc/util/rewinder.h"
+#include "yakc/util/memstats.h"
+#include "yakc/util/iostats.h"
+#include "yakc/util/coverage.h"
+#include "yakc/util/paste.h"
+#include "yakc/util/idle.h"
+#include "yakc/util/bootcache.h"
+#include "yakc/util/fork_state.h"
 #include <functional>
 
 namespace YAKC {
 
+/// functions of the active system emulator, resolved once at poweron
+struct sysfuncs {
+    void (*poweroff)();
+    void (*reset)();
+    void (*exec)(uint32_t micro_seconds);
+    void (*on_ascii)(uint8_t ascii);
+    void (*on_key_down)(uint8_t key);
+    void (*on_key_up)(uint8_t key);
+    void (*on_joystick)(uint8_t mask);
+    const void* (*framebuffer)(int& out_width, int& out_height);
+    void (*decode_audio)(float* buffer, int num_samples);
+    bool (*quickload)(filesystem* fs, const char* name, filetype type, bool start);
+    const char* (*system_info)();
+    int (*num_joysticks)();
+    bool (*tape_motor_on)();
+    paste_result (*paste_char)(uint8_t ascii);
+    void (*advance_timers)(uint32_t micro_seconds);
+    iostats::decode_func decode_io;
+};
+
+/// memory allocated by the emulator in bytes
+struct memory_report {
+    int sys_state = 0;      // machine state of the current system
+    int pixel_buffer = 0;   // pixel buffer of the current (or last) system
+    int rom_images = 0;     // copied ROM images
+    int filesystem = 0;     // filesystem byte store
+    int rewinder = 0;       // reverse debugging snapshots
+    int bootcache = 0;      // cached booted machine states
+    int memstats = 0;       // memory access counters
+    int iostats = 0;        // I/O access counters
+    int coverage = 0;       // code coverage bitmaps
+    int idle = 0;           // idle detection memory shadow
+    int total = 0;
+};
+
 class yakc {
 public:
-    /// one-time init
-    void init(const ext_funcs& funcs);
-    /// add a ROM image
-    void add_rom(rom_images::rom type, const uint8_t* ptr, int size);
+    /// constructor
+    yakc();
+    /// one-time init, with size of the filesystem byte store
+    void init(const ext_funcs& funcs, int fs_store_size=filesystem::default_store_size);
+    /// switch off and free all allocated memory, call init() to use again
+    void discard();
+    /// get the memory allocated by the emulator
+    memory_report memory_usage() const;
+    /// add a ROM image, return false if it doesn't match the known-good image
+    bool add_rom(rom_images::rom type, const uint8_t* ptr, int size);
+    /// add a ROM image by reference (data must remain valid)
+    bool add_rom_ref(rom_images::rom type, const uint8_t* ptr, int size);
     /// check if the required ROM images for a model/os combination are loaded
     bool check_roms(system model, os_rom os=os_rom::none);
     /// poweron one of the emus
@@ -30,9 +81,30 @@ public:
     void exec(int micro_secs);
     /// step over one instruction and return number of cycles (called by debuggers)
     uint32_t step();
+    /// step over one instruction without adding it to the debugger history (called by the rewinder)
+    uint32_t replay_step();
     /// step until function returns true
     uint32_t step_until(std::function<bool(uint32_t)> fn);
 
+    /// get size of a machine state snapshot of the current system
+    int snapshot_size() const;
+    /// write machine state snapshot to memory buffer of snapshot_size()
+    void save_snapshot(void* ptr) const;
+    /// restore machine state from snapshot
+    void load_snapshot(const void* ptr);
+    /// fork the current machine state (copy the result to create more forks)
+    fork_state fork() const;
+    /// continue running a forked machine state
+    void load_fork(const fork_state& state);
+    /// write the current machine state back into a fork (copy-on-write)
+    void save_fork(fork_state& state) const;
+    /// step back one instruction (needs rewinder recording)
+    bool step_back();
+    /// go back in time to previous execution of an address
+    bool run_back_to(uint16_t addr);
+    /// go back to previous breakpoint hit or oldest recorded state
+    bool reverse_continue();
+
     /// called when an ASCII key is pressed
     void on_ascii(uint8_t ascii);
     /// called when a non-ascii key is pressed down
@@ -50,6 +122,18 @@ public:
 
     /// get the command text for starting a tape load
     const char* load_tape_cmd();
+    /// get the command text for starting the inserted disc, or nullptr
+    const char* disc_boot_cmd();
+    /// return true if the emulated tape motor is on
+    bool tape_motor_on() const;
+    /// return true if the emulated floppy drive motor is on
+    bool disc_motor_on() const;
+    /// enable/disable running at max speed while the tape motor is on
+    void enable_auto_warp(system m, bool b);
+    /// return true if auto-warp is enabled for a system
+    bool is_auto_warp_enabled(system m) const;
+    /// write a character directly into the OS keyboard buffer
+    paste_result paste_char(uint8_t ascii);
     /// start a quickload (may not be finished when function returns)
     bool quickload(const char* name, filetype type, bool start);
 
@@ -72,9 +156,64 @@ public:
     system model = system::none;
     os_rom os = os_rom::none;
     class filesystem filesystem;
+    class rewinder rewinder;
+    class memstats memstats;
+    class iostats iostats;
+    class coverage coverage;
+    class paste paste;
+    class idle idle;
+    class bootcache bootcache;
     int accel = 1;      // current acceleration factor (must be > 0)
+    bool fast_tape = true;  // instantly load standard tape files (C64 and ZX)
+    bool fast_disc = false; // warp while the floppy drive motor is on (CPC only, FDC timing is unchanged)
+    bool fast_paste = true; // warp while pasting text
+    system auto_warp = system(int(system::any_c64)|int(system::any_cpc));  // systems with auto-warp enabled
+    int warp_budget_us = 12000;     // max wall-clock time per frame spent warping
+    int64_t warp_saved_us = 0;      // wall-clock time saved by auto-warp
+    static const int max_warp_frames = 256;
 private:
+    /// run the current system for a time span, and do the per-frame work on emulated frame boundaries
+    void exec_system(int micro_secs);
+    /// return true if the machine state may change between exec calls
+    bool input_pending() const;
+    /// run the current system for a time span
+    void exec_current_system(int micro_secs);
+    /// run extra frames while the tape or disc motor is on
+    void warp(int micro_secs);
+    /// return true if the emulation should currently run at max speed
+    bool warp_active() const;
+    /// boot the OS or restore the booted state from the boot cache
+    void boot();
+    /// get the emulated time the OS of the current system needs to boot
+    int boot_time_us() const;
+    /// compute the boot cache key of the current system before booting
+    uint64_t boot_cache_key() const;
+    /// count down the boot time and cache the booted machine state
+    void record_boot(int micro_secs);
+    /// setup idle detection for the current system
+    void setup_idle();
+    /// setup the I/O access decoder for the current system
+    void setup_iostats();
+    /// set the ROM images mapped by the current system for code coverage
+    void setup_coverage();
+    /// advance RAM timers and the audio stream while frames are skipped
+    void advance_timers(int micro_secs);
+
+    /// select the function table of the active system
+    void select_system();
+
+    sysfuncs sys;
     bool joystick_enabled = false;
+    bool boot_pending = false;
+    int boot_record_us = 0;     // remaining boot time until the state is cached (0: not recording)
+    uint64_t boot_key = 0;
+    int skip_audio_us = 0;      // skipped time not yet filled with audio samples
+    static const int frame_length_us = 20000;   // emulated frame length for per-frame work
+    int frame_time_us = 0;      // emulated time since the last frame boundary
+    bool frame_begin = true;    // a frame boundary has been crossed since the last exec call
+    static const int input_hold_length_us = 5 * frame_length_us;  // covers delayed key releases
+    int input_hold_us = 0;      // remaining time in which input may change the state between calls
+    uint8_t joystick_mask = 0;
 };
 
 } // namespace YAKC
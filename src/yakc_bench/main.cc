@@ -0,0 +1,298 @@
+//------------------------------------------------------------------------------
+//  yakc_bench main.cc
+//
+//  Headless emulation throughput benchmark. Boots each system, runs
+//  fixed workloads (idle prompt, a BASIC loop, a game) and writes
+//  the results as JSON to stdout:
+//
+//  yakc_bench [-dir path] [-system name] [-workload idle|basic|game]
+//             [-frames N] [-reps N] [-warmup N]
+//
+//  ROM images and programs are mapped from the 'files' directory.
+//  After warm-up, the machine state is captured, and every repetition
+//  starts from this snapshot, so all repetitions do the same work.
+//  Ticks, instructions and I/O accesses per chip are counted in a
+//  separate, untimed run.
+//------------------------------------------------------------------------------
+#include "yakc/yakc.h"
+#include "yakc/util/breadboard.h"
+#include "yakc/util/mapped_file.h"
+#include "yakc/roms/rom_dumps.h"
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+
+using namespace YAKC;
+
+static const int frame_us = 20000;
+static const int max_paste_frames = 3000;
+
+struct bench_system {
+    YAKC::system model;
+    os_rom os;
+    const char* basic;      // BASIC loop workload as typed text, or nullptr
+    const char* game;       // game workload file name, or nullptr
+    filetype game_type;
+    const char* game_cmd;   // text to type after loading the game, or nullptr
+};
+static const bench_system systems[] = {
+    { YAKC::system::kc85_2,         os_rom::caos_2_2, nullptr, nullptr, filetype::none, nullptr },
+    { YAKC::system::kc85_3,         os_rom::caos_3_1, "BASIC\n\n10 A=A+1:GOTO 10\nRUN\n", "pengo.kcc", filetype::kcc, nullptr },
+    { YAKC::system::kc85_4,         os_rom::caos_4_2, "BASIC\n\n10 A=A+1:GOTO 10\nRUN\n", "pengo4.kcc", filetype::kcc, nullptr },
+    { YAKC::system::z1013_01,       os_rom::none, nullptr, "galactica.z80", filetype::kc_z80, nullptr },
+    { YAKC::system::z1013_16,       os_rom::none, nullptr, "boulderdash_1_0.z80", filetype::kc_z80, nullptr },
+    { YAKC::system::z1013_64,       os_rom::none, nullptr, "boulderdash_1_0.z80", filetype::kc_z80, nullptr },
+    { YAKC::system::z9001,          os_rom::none, "BASIC\n\n10 A=A+1:GOTO 10\nRUN\n", nullptr, filetype::none, nullptr },
+    { YAKC::system::kc87,           os_rom::none, "BASIC\n\n10 A=A+1:GOTO 10\nRUN\n", nullptr, filetype::none, nullptr },
+    { YAKC::system::zxspectrum48k,  os_rom::none, nullptr, "bombjack_zx.z80", filetype::zx_z80, nullptr },
+    { YAKC::system::zxspectrum128k, os_rom::none, "\n10 LET A=A+1: GO TO 10\nRUN\n", "arkanoid_zx128k.z80", filetype::zx_z80, nullptr },
+    { YAKC::system::cpc464,         os_rom::none, "10 a=a+1:goto 10\nrun\n", "arkanoid.sna", filetype::cpc_sna, nullptr },
+    { YAKC::system::cpc6128,        os_rom::none, "10 a=a+1:goto 10\nrun\n", "dtc.sna", filetype::cpc_sna, nullptr },
+    { YAKC::system::kccompact,      os_rom::none, "10 a=a+1:goto 10\nrun\n", "arkanoid.sna", filetype::cpc_sna, nullptr },
+    { YAKC::system::acorn_atom,     os_rom::none, "10 A=A+1;GOTO 10\nRUN\n", nullptr, filetype::none, nullptr },
+    { YAKC::system::c64_pal,        os_rom::none, "10 A=A+1:GOTO 10\nRUN\n", "boulderdash_c64.tap", filetype::c64_tap, "LOAD\n" },
+};
+static const char* workloads[] = { "idle", "basic", "game" };
+
+struct options {
+    const char* dir = "files";
+    const char* sys_name = nullptr;
+    const char* workload = nullptr;
+    int frames = 250;
+    int reps = 5;
+    int warmup = 100;
+};
+
+struct counters {
+    uint64_t ticks = 0;
+    uint64_t instructions = 0;
+};
+
+static yakc emu;
+static mapped_file rom_files[rom_images::num_roms];
+
+//------------------------------------------------------------------------------
+static void
+count_ticks(int num_ticks, uint64_t pins, void* user_data) {
+    counters* c = (counters*) user_data;
+    c->ticks += num_ticks;
+    if (board.z80) {
+        if ((pins & (Z80_M1|Z80_MREQ)) == (Z80_M1|Z80_MREQ)) {
+            c->instructions++;
+        }
+    }
+    else if (pins & M6502_SYNC) {
+        c->instructions++;
+    }
+}
+
+//------------------------------------------------------------------------------
+static void
+load_roms(const char* dir) {
+    // the KC85/3 ROMs are built in, all others are mapped from the files directory
+    emu.add_rom_ref(rom_images::caos31, dump_caos31, sizeof(dump_caos31));
+    emu.add_rom_ref(rom_images::kc85_basic_rom, dump_basic_c0, sizeof(dump_basic_c0));
+    char path[1024];
+    for (int i = 0; i < rom_images::num_roms; i++) {
+        const rom_images::rom type = rom_images::rom(i);
+        if (!roms.has(type)) {
+            snprintf(path, sizeof(path), "%s/%s", dir, rom_images::filename(type));
+            if (rom_files[i].open(path)) {
+                emu.add_rom_ref(type, rom_files[i].ptr(), rom_files[i].size());
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+static void
+run_frames(int num_frames) {
+    for (int i = 0; i < num_frames; i++) {
+        emu.exec(frame_us);
+    }
+}
+
+//------------------------------------------------------------------------------
+static void
+type_text(const char* text) {
+    emu.paste.start((const uint8_t*)text, (int)strlen(text));
+    for (int i = 0; emu.paste.is_active() && (i < max_paste_frames); i++) {
+        emu.exec(frame_us);
+    }
+}
+
+//------------------------------------------------------------------------------
+/// setup the workload and warm up, return nullptr on success, or reason for skipping
+static const char*
+prepare(const bench_system& sys, const char* workload, const options& opts, mapped_file& file) {
+    if (0 == strcmp(workload, "basic")) {
+        if (!sys.basic) {
+            return "no BASIC at the prompt";
+        }
+        run_frames(opts.warmup);
+        type_text(sys.basic);
+    }
+    else if (0 == strcmp(workload, "game")) {
+        if (!sys.game) {
+            return "no game";
+        }
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", opts.dir, sys.game);
+        if (!file.open(path)) {
+            return "game file not found";
+        }
+        emu.filesystem.add(sys.game, file.ptr(), file.size(), filesystem::ownership::borrow);
+        if (!emu.quickload(sys.game, sys.game_type, true)) {
+            return "failed to load game";
+        }
+        if (sys.game_cmd) {
+            type_text(sys.game_cmd);
+        }
+    }
+    run_frames(opts.warmup);
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+/// write the I/O access counters of all accessed chips as JSON
+static void
+write_iostats(const iostats& stats) {
+    printf("\"io\": { ");
+    bool first = true;
+    for (int i = 0; i < iostats::num_chips; i++) {
+        const chip::id c = chip::id(1<<i);
+        const uint32_t reads = stats.count(c, iostats::read);
+        const uint32_t writes = stats.count(c, iostats::write);
+        if (reads || writes) {
+            printf("%s\"%s\": { \"reads_per_sec\": %.0f, \"writes_per_sec\": %.0f }",
+                first ? "" : ", ", string_from_chip(c), stats.rate(reads), stats.rate(writes));
+            first = false;
+        }
+    }
+    printf(" }, ");
+}
+
+//------------------------------------------------------------------------------
+static void
+run_bench(const bench_system& sys, const char* workload, const options& opts, bool& first) {
+    printf("%s\n    { \"system\": \"%s\", \"workload\": \"%s\", ", first ? "" : ",", string_from_system(sys.model), workload);
+    first = false;
+    if (!emu.check_roms(sys.model, sys.os)) {
+        printf("\"status\": \"skipped\", \"reason\": \"missing ROM images\" }");
+        return;
+    }
+    emu.poweron(sys.model, sys.os);
+    mapped_file file;
+    const char* reason = prepare(sys, workload, opts, file);
+    if (reason) {
+        printf("\"status\": \"skipped\", \"reason\": \"%s\" }", reason);
+        emu.poweroff();
+        emu.filesystem.reset();
+        return;
+    }
+
+    // all runs start from the state after warm-up
+    uint8_t* snapshot = (uint8_t*) malloc(emu.snapshot_size());
+    emu.save_snapshot(snapshot);
+
+    // count ticks and instructions in an untimed run
+    counters cnt;
+    board.tickhook.add(count_ticks, &cnt);
+    emu.iostats.clear();
+    emu.iostats.enable();
+    emu.load_snapshot(snapshot);
+    run_frames(opts.frames);
+    emu.iostats.disable();
+    board.tickhook.remove(count_ticks, &cnt);
+
+    // timed repetitions
+    double sum = 0.0, sum_sq = 0.0, min_ns = 0.0, max_ns = 0.0;
+    for (int rep = 0; rep < opts.reps; rep++) {
+        emu.load_snapshot(snapshot);
+        const auto start = std::chrono::steady_clock::now();
+        run_frames(opts.frames);
+        const auto end = std::chrono::steady_clock::now();
+        const double ns = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        sum += ns;
+        sum_sq += ns * ns;
+        if ((0 == rep) || (ns < min_ns)) {
+            min_ns = ns;
+        }
+        if ((0 == rep) || (ns > max_ns)) {
+            max_ns = ns;
+        }
+    }
+    free(snapshot);
+    emu.poweroff();
+    emu.filesystem.reset();
+
+    const double mean = sum / opts.reps;
+    const double var = (sum_sq / opts.reps) - (mean * mean);
+    const double stddev = (var > 0.0) ? sqrt(var) : 0.0;
+    printf("\"status\": \"ok\", \"ticks\": %llu, \"instructions\": %llu, ",
+        (unsigned long long)cnt.ticks, (unsigned long long)cnt.instructions);
+    printf("\"emulated_mhz\": %.3f, \"instructions_per_sec\": %.0f, ",
+        (cnt.ticks * 1000.0) / mean, (cnt.instructions * 1.0e9) / mean);
+    write_iostats(emu.iostats);
+    printf("\"ns_per_frame\": { \"mean\": %.0f, \"stddev\": %.0f, \"min\": %.0f, \"max\": %.0f } }",
+        mean / opts.frames, stddev / opts.frames, min_ns / opts.frames, max_ns / opts.frames);
+    fflush(stdout);
+}
+
+//------------------------------------------------------------------------------
+int
+main(int argc, const char** argv) {
+    options opts;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* val = (i + 1) < argc ? argv[i + 1] : nullptr;
+        if (!val) {
+            fprintf(stderr, "missing value for '%s'\n", arg);
+            return 10;
+        }
+        if (0 == strcmp(arg, "-dir"))           { opts.dir = val; }
+        else if (0 == strcmp(arg, "-system"))   { opts.sys_name = val; }
+        else if (0 == strcmp(arg, "-workload")) { opts.workload = val; }
+        else if (0 == strcmp(arg, "-frames"))   { opts.frames = atoi(val); }
+        else if (0 == strcmp(arg, "-reps"))     { opts.reps = atoi(val); }
+        else if (0 == strcmp(arg, "-warmup"))   { opts.warmup = atoi(val); }
+        else {
+            fprintf(stderr, "unknown argument '%s'\n", arg);
+            return 10;
+        }
+        i++;
+    }
+    if ((opts.frames <= 0) || (opts.reps <= 0) || (opts.warmup < 0)) {
+        fprintf(stderr, "invalid -frames, -reps or -warmup\n");
+        return 10;
+    }
+
+    emu.init(default_ext_funcs());
+    load_roms(opts.dir);
+
+    // no wall-clock dependent behaviour
+    emu.auto_warp = YAKC::system::none;
+    emu.fast_disc = false;
+    emu.fast_paste = false;
+    // every run boots the OS in real time
+    emu.bootcache.enabled = false;
+
+    printf("{\n  \"benchmark\": \"yakc_bench\", \"version\": 1,\n");
+    printf("  \"frame_us\": %d, \"frames\": %d, \"reps\": %d, \"warmup_frames\": %d,\n",
+        frame_us, opts.frames, opts.reps, opts.warmup);
+    printf("  \"results\": [");
+    bool first = true;
+    for (const auto& sys : systems) {
+        if (opts.sys_name && (system_from_string(opts.sys_name) != sys.model)) {
+            continue;
+        }
+        for (const char* workload : workloads) {
+            if (opts.workload && strcmp(opts.workload, workload)) {
+                continue;
+            }
+            run_bench(sys, workload, opts, first);
+        }
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,342 @@
+//------------------------------------------------------------------------------
+//  yakc_capi.cc
+//------------------------------------------------------------------------------
+#include "yakc_capi.h"
+#include "yakc/yakc.h"
+#include "yakc/util/breadboard.h"
+
+using namespace YAKC;
+
+// the single emulator instance, the handle is just a pointer to it
+struct yakc_emu {
+    YAKC::yakc emu;
+    bool created = false;
+};
+static yakc_emu instance;
+static_assert(YAKC_EMU_AUDIO_CHUNK_SIZE == audiobuffer::chunk_size, "audio chunk size mismatch");
+
+//------------------------------------------------------------------------------
+static void
+count_ticks(int num_ticks, uint64_t /*pins*/, void* user_data) {
+    *(uint64_t*)user_data += num_ticks;
+}
+
+//------------------------------------------------------------------------------
+extern "C" yakc_emu_t*
+yakc_emu_create(const yakc_emu_desc_t* desc) {
+    if (instance.created) {
+        return nullptr;
+    }
+    ext_funcs funcs = default_ext_funcs();
+    if (desc && desc->assert_func) {
+        funcs.assertmsg_func = desc->assert_func;
+    }
+    if (desc && desc->malloc_func) {
+        funcs.malloc_func = desc->malloc_func;
+    }
+    if (desc && desc->free_func) {
+        funcs.free_func = desc->free_func;
+    }
+    const int fs_size = (desc && (desc->fs_store_size > 0)) ? desc->fs_store_size : filesystem::default_store_size;
+    instance.emu.init(funcs, fs_size);
+
+    // nothing may depend on the host's wall-clock time, and the OS
+    // boot always runs as part of the first emulated cycles
+    instance.emu.auto_warp = YAKC::system::none;
+    instance.emu.fast_disc = false;
+    instance.emu.fast_paste = false;
+    instance.emu.bootcache.enabled = false;
+    instance.created = true;
+    return &instance;
+}
+
+//------------------------------------------------------------------------------
+extern "C" void
+yakc_emu_destroy(yakc_emu_t* inst) {
+    YAKC_ASSERT(inst && inst->created);
+    inst->emu.discard();
+    inst->created = false;
+}
+
+//------------------------------------------------------------------------------
+extern "C" void
+yakc_emu_memory(yakc_emu_t* inst, yakc_emu_memory_t* out) {
+    YAKC_ASSERT(inst && out);
+    const memory_report r = inst->emu.memory_usage();
+    out->sys_state = r.sys_state;
+    out->pixel_buffer = r.pixel_buffer;
+    out->rom_images = r.rom_images;
+    out->filesystem = r.filesystem;
+    out->rewinder = r.rewinder;
+    out->bootcache = r.bootcache;
+    out->stats = r.memstats + r.iostats + r.coverage + r.idle;
+    out->total = r.total;
+}
+
+//------------------------------------------------------------------------------
+extern "C" int
+yakc_emu_add_rom(yakc_emu_t* inst, const uint8_t* ptr, int size) {
+    YAKC_ASSERT(inst && ptr && (size > 0));
+    const rom_images::rom type = rom_images::identify(ptr, size);
+    if (rom_images::num_roms == type) {
+        return 0;
+    }
+    return inst->emu.add_rom(type, ptr, size) ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+extern "C" int
+yakc_emu_poweron(yakc_emu_t* inst, const char* system_str, const char* os_str) {
+    YAKC_ASSERT(inst && system_str);
+    const YAKC::system model = system_from_string(system_str);
+    const os_rom os = os_str ? os_from_string(os_str) : os_rom::none;
+    if ((YAKC::system::none == model) || !inst->emu.check_roms(model, os)) {
+        return 0;
+    }
+    inst->emu.poweroff();
+    inst->emu.poweron(model, os);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+extern "C" void
+yakc_emu_poweroff(yakc_emu_t* inst) {
+    YAKC_ASSERT(inst);
+    inst->emu.poweroff();
+}
+
+//------------------------------------------------------------------------------
+extern "C" void
+yakc_emu_reset(yakc_emu_t* inst) {
+    YAKC_ASSERT(inst);
+    inst->emu.reset();
+}
+
+//------------------------------------------------------------------------------
+extern "C" yakc_emu_cpu_t
+yakc_emu_cpu(yakc_emu_t* inst) {
+    YAKC_ASSERT(inst);
+    if (!inst->emu.switchedon()) {
+        return YAKC_EMU_CPU_NONE;
+    }
+    return (cpu_model::z80 == inst->emu.cpu_type()) ? YAKC_EMU_CPU_Z80 : YAKC_EMU_CPU_M6502;
+}
+
+//------------------------------------------------------------------------------
+extern "C" int
+yakc_emu_load(yakc_emu_t* inst, const char* name, const char* type_str, const void* data, int size, int start) {
+    YAKC_ASSERT(inst && name && type_str && data && (size > 0));
+    const filetype type = filetype_from_string(type_str);
+    if (!inst->emu.switchedon() || (filetype::none == type) || (filetype::text == type)) {
+        return 0;
+    }
+    // tape files are read while the emulation runs, so the data must be copied
+    inst->emu.filesystem.rm(name);
+    if (!inst->emu.filesystem.add(name, data, size, filesystem::ownership::copy)) {
+        return 0;
+    }
+    return inst->emu.quickload(name, type, 0 != start) ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+extern "C" uint64_t
+yakc_emu_run_cycles(yakc_emu_t* inst, uint64_t cycles) {
+    YAKC_ASSERT(inst);
+    if (!inst->emu.switchedon() || (0 == cycles)) {
+        return 0;
+    }
+    // the system emulators run in emulated time, so run in slices and
+    // compute the next slice from the measured cycles per microsecond
+    uint64_t ticks = 0;
+    if (!board.tickhook.add(count_ticks, &ticks)) {
+        YAKC_ASSERT(false);
+        return 0;
+    }
+    uint64_t micro_secs = 0;
+    int slice_us = 1000;
+    while (ticks < cycles) {
+        const uint64_t start_ticks = ticks;
+        inst->emu.exec(slice_us);
+        micro_secs += slice_us;
+        if (ticks == start_ticks) {
+            // stopped at a breakpoint
+            break;
+        }
+        const double us = double(cycles - ticks) * double(micro_secs) / double(ticks);
+        slice_us = (us < 1.0) ? 1 : ((us > YAKC_EMU_FRAME_US) ? YAKC_EMU_FRAME_US : int(us));
+    }
+    board.tickhook.remove(count_ticks, &ticks);
+    return ticks;
+}
+
+//------------------------------------------------------------------------------
+extern "C" void
+yakc_emu_run_until_frame(yakc_emu_t* inst) {
+    YAKC_ASSERT(inst);
+    if (inst->emu.switchedon()) {
+        inst->emu.exec(YAKC_EMU_FRAME_US);
+    }
+}
+
+//------------------------------------------------------------------------------
+extern "C" void
+yakc_emu_ascii(yakc_emu_t* inst, uint8_t ascii) {
+    YAKC_ASSERT(inst);
+    inst->emu.on_ascii(ascii);
+}
+
+//------------------------------------------------------------------------------
+extern "C" void
+yakc_emu_key_down(yakc_emu_t* inst, uint8_t key) {
+    YAKC_ASSERT(inst);
+    inst->emu.on_key_down(key);
+}
+
+//------------------------------------------------------------------------------
+extern "C" void
+yakc_emu_key_up(yakc_emu_t* inst, uint8_t key) {
+    YAKC_ASSERT(inst);
+    inst->emu.on_key_up(key);
+}
+
+//------------------------------------------------------------------------------
+extern "C" void
+yakc_emu_joystick(yakc_emu_t* inst, uint8_t mask) {
+    YAKC_ASSERT(inst);
+    // the pad mask is used even if keyboard joystick emulation is disabled
+    inst->emu.on_joystick(0, mask);
+}
+
+//------------------------------------------------------------------------------
+extern "C" int
+yakc_emu_read_memory(yakc_emu_t* inst, uint16_t addr, uint8_t* dst, int num_bytes) {
+    YAKC_ASSERT(inst && dst && (num_bytes >= 0));
+    if (!inst->emu.switchedon() || !board.mem) {
+        return 0;
+    }
+    for (int i = 0; i < num_bytes; i++) {
+        dst[i] = mem_rd(board.mem, uint16_t(addr + i));
+    }
+    return num_bytes;
+}
+
+//------------------------------------------------------------------------------
+extern "C" int
+yakc_emu_write_memory(yakc_emu_t* inst, uint16_t addr, const uint8_t* src, int num_bytes) {
+    YAKC_ASSERT(inst && src && (num_bytes >= 0));
+    if (!inst->emu.switchedon() || !board.mem) {
+        return 0;
+    }
+    for (int i = 0; i < num_bytes; i++) {
+        mem_wr(board.mem, uint16_t(addr + i), src[i]);
+    }
+    return num_bytes;
+}
+
+//------------------------------------------------------------------------------
+extern "C" int
+yakc_emu_get_reg(yakc_emu_t* inst, yakc_emu_reg_t reg) {
+    YAKC_ASSERT(inst);
+    if (!inst->emu.switchedon()) {
+        return -1;
+    }
+    if (board.z80) {
+        z80_t* cpu = board.z80;
+        switch (reg) {
+            case YAKC_EMU_REG_Z80_AF:   return z80_af(cpu);
+            case YAKC_EMU_REG_Z80_BC:   return z80_bc(cpu);
+            case YAKC_EMU_REG_Z80_DE:   return z80_de(cpu);
+            case YAKC_EMU_REG_Z80_HL:   return z80_hl(cpu);
+            case YAKC_EMU_REG_Z80_IX:   return z80_ix(cpu);
+            case YAKC_EMU_REG_Z80_IY:   return z80_iy(cpu);
+            case YAKC_EMU_REG_Z80_SP:   return z80_sp(cpu);
+            case YAKC_EMU_REG_Z80_PC:   return z80_pc(cpu);
+            case YAKC_EMU_REG_Z80_AF_:  return z80_af_(cpu);
+            case YAKC_EMU_REG_Z80_BC_:  return z80_bc_(cpu);
+            case YAKC_EMU_REG_Z80_DE_:  return z80_de_(cpu);
+            case YAKC_EMU_REG_Z80_HL_:  return z80_hl_(cpu);
+            case YAKC_EMU_REG_Z80_I:    return z80_i(cpu);
+            case YAKC_EMU_REG_Z80_R:    return z80_r(cpu);
+            case YAKC_EMU_REG_Z80_IM:   return z80_im(cpu);
+            default:                    return -1;
+        }
+    }
+    else if (board.m6502) {
+        const m6502_t* cpu = board.m6502;
+        switch (reg) {
+            case YAKC_EMU_REG_M6502_A:  return cpu->state.A;
+            case YAKC_EMU_REG_M6502_X:  return cpu->state.X;
+            case YAKC_EMU_REG_M6502_Y:  return cpu->state.Y;
+            case YAKC_EMU_REG_M6502_S:  return cpu->state.S;
+            case YAKC_EMU_REG_M6502_P:  return cpu->state.P;
+            case YAKC_EMU_REG_M6502_PC: return cpu->state.PC;
+            default:                    return -1;
+        }
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+extern "C" int
+yakc_emu_set_reg(yakc_emu_t* inst, yakc_emu_reg_t reg, uint16_t val) {
+    YAKC_ASSERT(inst);
+    if (!inst->emu.switchedon()) {
+        return 0;
+    }
+    if (board.z80) {
+        z80_t* cpu = board.z80;
+        switch (reg) {
+            case YAKC_EMU_REG_Z80_AF:   z80_set_af(cpu, val); break;
+            case YAKC_EMU_REG_Z80_BC:   z80_set_bc(cpu, val); break;
+            case YAKC_EMU_REG_Z80_DE:   z80_set_de(cpu, val); break;
+            case YAKC_EMU_REG_Z80_HL:   z80_set_hl(cpu, val); break;
+            case YAKC_EMU_REG_Z80_IX:   z80_set_ix(cpu, val); break;
+            case YAKC_EMU_REG_Z80_IY:   z80_set_iy(cpu, val); break;
+            case YAKC_EMU_REG_Z80_SP:   z80_set_sp(cpu, val); break;
+            case YAKC_EMU_REG_Z80_PC:   z80_set_pc(cpu, val); break;
+            case YAKC_EMU_REG_Z80_AF_:  z80_set_af_(cpu, val); break;
+            case YAKC_EMU_REG_Z80_BC_:  z80_set_bc_(cpu, val); break;
+            case YAKC_EMU_REG_Z80_DE_:  z80_set_de_(cpu, val); break;
+            case YAKC_EMU_REG_Z80_HL_:  z80_set_hl_(cpu, val); break;
+            case YAKC_EMU_REG_Z80_I:    z80_set_i(cpu, uint8_t(val)); break;
+            case YAKC_EMU_REG_Z80_R:    z80_set_r(cpu, uint8_t(val)); break;
+            case YAKC_EMU_REG_Z80_IM:   z80_set_im(cpu, uint8_t(val)); break;
+            default:                    return 0;
+        }
+        return 1;
+    }
+    else if (board.m6502) {
+        m6502_t* cpu = board.m6502;
+        switch (reg) {
+            case YAKC_EMU_REG_M6502_A:  cpu->state.A = uint8_t(val); break;
+            case YAKC_EMU_REG_M6502_X:  cpu->state.X = uint8_t(val); break;
+            case YAKC_EMU_REG_M6502_Y:  cpu->state.Y = uint8_t(val); break;
+            case YAKC_EMU_REG_M6502_S:  cpu->state.S = uint8_t(val); break;
+            case YAKC_EMU_REG_M6502_P:  cpu->state.P = uint8_t(val); break;
+            case YAKC_EMU_REG_M6502_PC: cpu->state.PC = val; break;
+            default:                    return 0;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+extern "C" const uint32_t*
+yakc_emu_framebuffer(yakc_emu_t* inst, int* out_width, int* out_height) {
+    YAKC_ASSERT(inst && out_width && out_height);
+    *out_width = 0;
+    *out_height = 0;
+    if (!inst->emu.switchedon()) {
+        return nullptr;
+    }
+    return (const uint32_t*) inst->emu.framebuffer(*out_width, *out_height);
+}
+
+//------------------------------------------------------------------------------
+extern "C" void
+yakc_emu_audio(yakc_emu_t* inst, float* buffer, int num_samples) {
+    YAKC_ASSERT(inst && buffer);
+    YAKC_ASSERT((num_samples > 0) && (0 == (num_samples % YAKC_EMU_AUDIO_CHUNK_SIZE)));
+    inst->emu.fill_sound_samples(buffer, num_samples);
+}
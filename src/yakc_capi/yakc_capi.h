@@ -0,0 +1,159 @@
+#pragma once
+/*------------------------------------------------------------------------------
+    yakc_capi.h
+
+    C API for embedding the emulator into other programs (e.g. test
+    orchestration or scripting languages through an FFI), without
+    any UI, rendering or audio output.
+
+    The system emulators are process-wide singletons, so only one
+    emulator instance can exist at a time, yakc_emu_create() returns
+    NULL if an instance already exists.
+
+    Memory is only allocated when creating the instance, adding ROMs
+    and when a system with a different display size is switched on
+    (the pixel buffer). All other functions run without allocating memory: loaded
+    files are copied into the filesystem byte store which is allocated
+    once at creation time, framebuffer pixels are returned by pointer,
+    and memory and audio data is copied into buffers provided by the
+    caller.
+
+    For reproducible runs, warping (on tape or disc activity, or while
+    pasting text) is disabled, so that the emulation never depends
+    on the host's wall-clock time. The boot cache is disabled too,
+    the OS always boots in the first emulated cycles after poweron,
+    and these cycles are included in yakc_emu_run_cycles().
+
+    Basic usage:
+
+    yakc_emu_t* emu = yakc_emu_create(NULL);
+    yakc_emu_add_rom(emu, rom_data, rom_size);    // if required by system
+    if (yakc_emu_poweron(emu, "zxspectrum48k", NULL)) {
+        yakc_emu_run_cycles(emu, 3500000);
+        ...
+    }
+    yakc_emu_destroy(emu);
+------------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* opaque emulator instance handle */
+typedef struct yakc_emu yakc_emu_t;
+
+/* length of a frame in run_until_frame() in microseconds (50 Hz) */
+#define YAKC_EMU_FRAME_US (20000)
+/* audio samples are pulled in multiples of this number of samples */
+#define YAKC_EMU_AUDIO_CHUNK_SIZE (128)
+
+/* creation parameters, zero-initialized members use defaults */
+typedef struct {
+    void* (*malloc_func)(size_t size);      /* default: malloc */
+    void (*free_func)(void* ptr);           /* default: free */
+    void (*assert_func)(const char* cond, const char* msg, const char* file, int line, const char* func); /* default: print to stderr */
+    int fs_store_size;                      /* filesystem byte store size in bytes (for loaded files) */
+} yakc_emu_desc_t;
+
+/* memory allocated by the emulator in bytes */
+typedef struct {
+    int sys_state;          /* machine state of the current system */
+    int pixel_buffer;       /* pixel buffer of the current (or last) system */
+    int rom_images;         /* copied ROM images */
+    int filesystem;         /* filesystem byte store */
+    int rewinder;           /* reverse debugging snapshots */
+    int bootcache;          /* cached booted machine states */
+    int stats;              /* memory and I/O access counters, coverage and idle detection */
+    int total;
+} yakc_emu_memory_t;
+
+/* the CPU type of the running system */
+typedef enum {
+    YAKC_EMU_CPU_NONE = 0,
+    YAKC_EMU_CPU_Z80,
+    YAKC_EMU_CPU_M6502,
+} yakc_emu_cpu_t;
+
+/* CPU register ids */
+typedef enum {
+    /* Z80 */
+    YAKC_EMU_REG_Z80_AF = 0,
+    YAKC_EMU_REG_Z80_BC,
+    YAKC_EMU_REG_Z80_DE,
+    YAKC_EMU_REG_Z80_HL,
+    YAKC_EMU_REG_Z80_IX,
+    YAKC_EMU_REG_Z80_IY,
+    YAKC_EMU_REG_Z80_SP,
+    YAKC_EMU_REG_Z80_PC,
+    YAKC_EMU_REG_Z80_AF_,
+    YAKC_EMU_REG_Z80_BC_,
+    YAKC_EMU_REG_Z80_DE_,
+    YAKC_EMU_REG_Z80_HL_,
+    YAKC_EMU_REG_Z80_I,
+    YAKC_EMU_REG_Z80_R,
+    YAKC_EMU_REG_Z80_IM,
+    /* 6502 */
+    YAKC_EMU_REG_M6502_A,
+    YAKC_EMU_REG_M6502_X,
+    YAKC_EMU_REG_M6502_Y,
+    YAKC_EMU_REG_M6502_S,
+    YAKC_EMU_REG_M6502_P,
+    YAKC_EMU_REG_M6502_PC,
+
+    YAKC_EMU_NUM_REGS
+} yakc_emu_reg_t;
+
+/* create the emulator instance (desc may be NULL), returns NULL if an instance exists */
+yakc_emu_t* yakc_emu_create(const yakc_emu_desc_t* desc);
+/* switch off and destroy the emulator instance, frees all memory except ROM images */
+void yakc_emu_destroy(yakc_emu_t* emu);
+/* get the memory allocated by the emulator */
+void yakc_emu_memory(yakc_emu_t* emu, yakc_emu_memory_t* out);
+
+/* add a ROM image (copied and identified by content), returns 0 if not a known ROM */
+int yakc_emu_add_rom(yakc_emu_t* emu, const uint8_t* ptr, int size);
+/* switch on a system by name (e.g. "kc85_3", "c64_pal"), os may be NULL, returns 0 if unknown or ROMs missing */
+int yakc_emu_poweron(yakc_emu_t* emu, const char* system, const char* os);
+/* switch off the current system */
+void yakc_emu_poweroff(yakc_emu_t* emu);
+/* reset the current system */
+void yakc_emu_reset(yakc_emu_t* emu);
+/* return the CPU type of the current system */
+yakc_emu_cpu_t yakc_emu_cpu(yakc_emu_t* emu);
+
+/* quickload a file from memory (data is copied), filetype by name (e.g. "kcc", "zx_z80"), returns 0 on failure */
+int yakc_emu_load(yakc_emu_t* emu, const char* name, const char* filetype, const void* data, int size, int start);
+
+/* run for at least a number of CPU cycles, returns the number of executed cycles */
+uint64_t yakc_emu_run_cycles(yakc_emu_t* emu, uint64_t cycles);
+/* run for one frame of YAKC_EMU_FRAME_US emulated microseconds */
+void yakc_emu_run_until_frame(yakc_emu_t* emu);
+
+/* an ASCII key was pressed (released automatically by the system emulator) */
+void yakc_emu_ascii(yakc_emu_t* emu, uint8_t ascii);
+/* a key is pressed down (ASCII or YAKC key code) */
+void yakc_emu_key_down(yakc_emu_t* emu, uint8_t key);
+/* a key is released */
+void yakc_emu_key_up(yakc_emu_t* emu, uint8_t key);
+/* set the joystick state as mask of YAKC joystick bits */
+void yakc_emu_joystick(yakc_emu_t* emu, uint8_t mask);
+
+/* read from the CPU-visible memory (wraps around at 64 KBytes), returns number of bytes read */
+int yakc_emu_read_memory(yakc_emu_t* emu, uint16_t addr, uint8_t* dst, int num_bytes);
+/* write to the CPU-visible memory (ROM writes are ignored), returns number of bytes written */
+int yakc_emu_write_memory(yakc_emu_t* emu, uint16_t addr, const uint8_t* src, int num_bytes);
+/* get a CPU register value, returns -1 if the register doesn't exist on the current CPU */
+int yakc_emu_get_reg(yakc_emu_t* emu, yakc_emu_reg_t reg);
+/* set a CPU register value, returns 0 if the register doesn't exist on the current CPU */
+int yakc_emu_set_reg(yakc_emu_t* emu, yakc_emu_reg_t reg, uint16_t value);
+
+/* get pointer to the RGBA8 framebuffer and its size, valid until the next run call */
+const uint32_t* yakc_emu_framebuffer(yakc_emu_t* emu, int* out_width, int* out_height);
+/* pull generated mono 44.1 kHz audio samples (multiple of YAKC_EMU_AUDIO_CHUNK_SIZE), pads if not enough samples are available */
+void yakc_emu_audio(yakc_emu_t* emu, float* buffer, int num_samples);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+//  ArchiveLoader.cc
+//------------------------------------------------------------------------------
+#include "ArchiveLoader.h"
+#include "IO/IO.h"
+#include "Core/String/StringBuilder.h"
+
+using namespace Oryol;
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+void
+ArchiveLoader::Setup(const String& localDir) {
+    if (localDir.IsValid()) {
+        StringBuilder strBuilder;
+        strBuilder.Format(1024, "%s/yakc.pak", localDir.AsCStr());
+        if (this->localFile.open(strBuilder.AsCStr())) {
+            this->onLoaded(this->localFile.ptr(), this->localFile.size());
+        }
+        return;
+    }
+    this->loading = true;
+    IO::Load("kcc:yakc.pak",
+        [this](IO::LoadResult ioRes) {
+            this->data = std::move(ioRes.Data);
+            this->onLoaded(this->data.Data(), this->data.Size());
+        },
+        [this](const URL& url, IOStatus::Code ioStatus) {
+            this->onLoaded(nullptr, 0);
+        });
+}
+
+//------------------------------------------------------------------------------
+void
+ArchiveLoader::Discard() {
+    this->Archive.close();
+    this->localFile.close();
+    this->data.Clear();
+    this->waiting.Clear();
+}
+
+//------------------------------------------------------------------------------
+void
+ArchiveLoader::onLoaded(const uint8_t* ptr, int size) {
+    this->loading = false;
+    if (ptr && !this->Archive.open(ptr, size)) {
+        Log::Warn("ArchiveLoader: yakc.pak is not a valid archive\n");
+    }
+    // NOTE: callbacks may call WhenReady again
+    Array<std::function<void()>> fns(std::move(this->waiting));
+    for (auto& fn : fns) {
+        fn();
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+ArchiveLoader::IsLoading() const {
+    return this->loading;
+}
+
+//------------------------------------------------------------------------------
+void
+ArchiveLoader::WhenReady(std::function<void()> fn) {
+    if (this->loading) {
+        this->waiting.Add(std::move(fn));
+    }
+    else {
+        fn();
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+ArchiveLoader::Contains(const char* name) const {
+    return this->Archive.is_open() && (this->Archive.find(name) >= 0);
+}
+
+//------------------------------------------------------------------------------
+bool
+ArchiveLoader::Extract(const char* name, Buffer& outBuffer) const {
+    if (!this->Archive.is_open()) {
+        return false;
+    }
+    const int index = this->Archive.find(name);
+    if (index < 0) {
+        return false;
+    }
+    outBuffer.Clear();
+    const int size = this->Archive.size(index);
+    uint8_t* dst = outBuffer.Add(size);
+    if (!this->Archive.extract(index, dst, size)) {
+        Log::Warn("ArchiveLoader: failed to extract '%s'\n", name);
+        outBuffer.Clear();
+        return false;
+    }
+    return true;
+}
+
+} // namespace YAKC
@@ -0,0 +1,49 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::ArchiveLoader
+    @brief fetch the packed ROM and software archive
+
+    Loads 'yakc.pak' with a single request (or maps it from the local
+    directory), the RomLoader and FileLoader then extract files from
+    the archive instead of fetching them one by one. If the archive
+    isn't available, the loaders fall back to loading single files.
+*/
+#include "yakc/util/archive.h"
+#include "yakc/util/mapped_file.h"
+#include "Core/String/String.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Buffer.h"
+#include <functional>
+
+namespace YAKC {
+
+class ArchiveLoader {
+public:
+    /// start loading the archive
+    void Setup(const Oryol::String& localDir);
+    /// discard the archive
+    void Discard();
+    /// return true while the archive is loading
+    bool IsLoading() const;
+    /// call a function once the archive has loaded or failed to load
+    void WhenReady(std::function<void()> fn);
+    /// test if the archive contains a file
+    bool Contains(const char* name) const;
+    /// decompress a file from the archive, return false if not found or corrupt
+    bool Extract(const char* name, Oryol::Buffer& outBuffer) const;
+
+    /// the archive
+    class archive Archive;
+
+private:
+    /// called when loading has finished
+    void onLoaded(const uint8_t* data, int size);
+
+    bool loading = false;
+    Oryol::Buffer data;
+    mapped_file localFile;
+    Oryol::Array<std::function<void()>> waiting;
+};
+
+} // namespace YAKC
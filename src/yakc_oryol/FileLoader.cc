@@ -13,129 +13,73 @@ FileLoader* FileLoader::pointer = nullptr;
 
 //------------------------------------------------------------------------------
 void
-FileLoader::Setup(yakc& emu_) {
+FileLoader::Setup(yakc& emu_, ArchiveLoader* archive_) {
     o_assert(nullptr == pointer);
     this->emu = &emu_;
+    this->archive = archive_;
     pointer = this;
-    this->Items.Add("Pengo", "pengo.kcc", filetype::kcc, system::kc85_3);
-    this->Items.Add("Pengo", "pengo4.kcc", filetype::kcc, system::kc85_4);
-    this->Items.Add("Cave", "cave.kcc", filetype::kcc, system::kc85_3);
-    this->Items.Add("Labyrinth", "labyrinth.kcc", filetype::kcc, system::kc85_3);
-    this->Items.Add("House", "house.kcc", filetype::kcc, system::kc85_3);
-    this->Items.Add("House", "house4.tap", filetype::kc_tap, system::kc85_4);
-    this->Items.Add("Jungle", "jungle.kcc", filetype::kcc, system::kc85_3);
-    this->Items.Add("Jungle", "jungle4.tap", filetype::kc_tap, system::kc85_4);
-    this->Items.Add("Pacman", "pacman.kcc", filetype::kcc, system::kc85_3);
-    this->Items.Add("Breakout", "breakout.kcc", filetype::kcc, system::kc85_3);
-    this->Items.Add("Mad Breakin", "breakin.853", filetype::kcc, system::kc85_3);
-    this->Items.Add("Boulderdash", "boulder3.tap", filetype::kc_tap, system::kc85_3);
-    this->Items.Add("Boulderdash", "boulder4.tap", filetype::kc_tap, system::kc85_4);
-    this->Items.Add("Digger", "digger3.tap", filetype::kc_tap, system::kc85_3);
-    this->Items.Add("Digger", "digger4.tap", filetype::kc_tap, system::kc85_4);
-    this->Items.Add("Tetris", "tetris.kcc", filetype::kcc, system::kc85_4);
-    this->Items.Add("Ladder", "ladder-3.kcc", filetype::kcc, system::kc85_3);
-    this->Items.Add("Enterprise", "enterpri.tap", filetype::kc_tap, system::any_kc85);
-    this->Items.Add("Chess", "chess.kcc", filetype::kcc, system::any_kc85);
-    this->Items.Add("Testbild", "testbild.kcc", filetype::kcc, system::kc85_3);
-    this->Items.Add("Demo1", "demo1.kcc", filetype::kcc, system::kc85_4);
-    this->Items.Add("Demo2", "demo2.kcc", filetype::kcc, system::kc85_4);
-    this->Items.Add("Demo3", "demo3.kcc", filetype::kcc, system::kc85_4);
-    this->Items.Add("Tiny-Basic 3.01", "tinybasic-3.01.z80", filetype::kc_z80, system::z1013_01);
-    this->Items.Add("KC-Basic", "kc_basic.z80", filetype::kc_z80, system::any_z1013);
-    this->Items.Add("Z1013 Forth", "z1013_forth.z80", filetype::kc_z80, system::any_z1013);
-    this->Items.Add("Boulderdash", "boulderdash_1_0.z80", filetype::kc_z80, system(int(system::z1013_16)|int(system::z1013_64)));
-    this->Items.Add("Demolation", "demolation.z80", filetype::kc_z80, system::any_z1013);
-    this->Items.Add("Cosmic Ball", "cosmic_ball.z80", filetype::kc_z80, system::z1013_01);
-    this->Items.Add("Galactica", "galactica.z80", filetype::kc_z80, system::any_z1013);
-    this->Items.Add("Mazogs", "mazog_deutsch.z80", filetype::kc_z80, system::any_z1013);
-    this->Items.Add("Monitor ZM30 (start with 'ZM')", "zm30.kcc", filetype::kcc, system::any_z9001);
-    this->Items.Add("Forth 83 (start with 'F83')", "F83_COM.TAP", filetype::kc_tap, system::any_z9001);
-    this->Items.Add("Arkanoid", "arkanoid.sna", filetype::cpc_sna, system::any_cpc, true);
-    this->Items.Add("Ghosts'n'Goblins", "ghosts_n_goblins.sna", filetype::cpc_sna, system::any_cpc, true);
-    this->Items.Add("Gryzor", "gryzor.sna", filetype::cpc_sna, system::cpc6128, true);
-    this->Items.Add("Dragon Ninja", "dragon_ninja.sna", filetype::cpc_sna, system::any_cpc, true);
-    this->Items.Add("Head over Heels", "head_over_heels.sna", filetype::cpc_sna, system::any_cpc, true);
-    this->Items.Add("Boulderdash", "boulder_dash.sna", filetype::cpc_sna, system::any_cpc, true);
-    this->Items.Add("Bomb Jack", "bomb_jack.sna", filetype::cpc_sna, system::any_cpc, true);
-    this->Items.Add("Chase HQ", "chase_hq.sna", filetype::cpc_sna, system::cpc6128, true);
-    this->Items.Add("Cybernoid", "cybernoid.sna", filetype::cpc_sna, system::any_cpc, true);
-    this->Items.Add("Fruity Frank", "fruity_frank.sna", filetype::cpc_sna, system(int(system::kccompact)|int(system::cpc6128)), true);
-    this->Items.Add("Ikari Warriors", "ikari_warriors.sna", filetype::cpc_sna, system::any_cpc, true);
-    this->Items.Add("1943", "1943.sna", filetype::cpc_sna, system::any_cpc, true);
-    this->Items.Add("Rick Dangerous", "rick_dangerous.sna", filetype::cpc_sna, system::any_cpc, true);
-    this->Items.Add("Donkey Kong", "donkey_kong.sna", filetype::cpc_sna, system::cpc6128, true);
-    this->Items.Add("DTC (Demo)", "dtc.sna", filetype::cpc_sna, system::cpc6128, true);
-    this->Items.Add("Wolfenstrad (Demo)", "wolfenstrad.sna", filetype::cpc_sna, system::cpc6128, true);
-    this->Items.Add("Ecole Buissonniere (Demo)", "ecole_buissonniere.sna", filetype::cpc_sna, system::cpc6128, true);
-    this->Items.Add("Backtro (Demo, broken)", "backtro.sna", filetype::cpc_sna, system::cpc6128, true);
-    this->Items.Add("From Scratch (Demo, broken)", "from_scratch.sna", filetype::cpc_sna, system::cpc6128, true);
-    this->Items.Add("Tire Au Flan (Demo, broken)", "tire_au_flan.sna", filetype::cpc_sna, system::any_cpc, true);
-    #if !ORYOL_EMSCRIPTEN
-    this->Items.Add("Acid Test: Colours", "cpcacid_colours.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: Border", "cpcacid_cpcborder.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: Col", "cpcacid_cpccol.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: Pen", "cpcacid_cpcpen.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: Pen 2", "cpcacid_cpcpen2.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: CPC Test", "cpcacid_cpctest.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: HBlank", "cpcacid_hblank.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: IOCol", "cpcacid_iocol.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: ModeTrig", "cpcacid_modetrig.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: OnlyInc", "cpcacid_onlyincpc.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: VBlank", "cpcacid_vblank.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: VBlank2", "cpcacid_vblank2.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: Video Test", "cpcacid_videotest.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: CPU", "cpcacid_cpu.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: InOut", "cpcacid_inout.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: PPI", "cpcacid_ppi.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: PPI Audio", "cpcacid_ppi_audio.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: PPI VSyncOut", "cpcacid_vsyncout.bin", filetype::cpc_bin, system::any_cpc, true);
-    this->Items.Add("Acid Test: HSyncLen", "cpcacid_hsynclen.bin", filetype::cpc_bin, system::any_cpc, true);
-    #endif
-    this->Items.Add("1942", "1942.tap", filetype::cpc_tap, system::cpc464, true);
-    this->Items.Add("Ghosts'n'Goblins", "ghostsng.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("Tir Na Nog", "tirnanog.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("Back to Reality", "backtore.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("ASSMON", "assmon.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("KC Pascal", "kcpascal.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("Bombjack 2", "bombjac1.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("Beverly Hills Cop", "beverlyh.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("Biff", "biff.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("Bubbler", "bubbler.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("Boulderdash 4", "boulder1.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("Combat Zone", "combatzo.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("Commandos", "commando.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("Curse of Sherwood", "curseofs.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("Kingdom of Speldom", "kingdomo.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("Haunted Hedges", "hauntedh.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("2088", "2088.tap", filetype::cpc_tap, system::any_cpc, true);
-    this->Items.Add("Exolon", "exolon.z80", filetype::zx_z80, system::zxspectrum48k, true);
-    this->Items.Add("Cyclone", "cyclone.z80", filetype::zx_z80, system::zxspectrum48k, true);
-    this->Items.Add("Boulderdash", "boulderdash_zx.z80", filetype::zx_z80, system::zxspectrum48k, true);
-    this->Items.Add("Bomb Jack", "bombjack_zx.z80", filetype::zx_z80, system::zxspectrum48k, true);
-    this->Items.Add("Arkanoid", "arkanoid_zx128k.z80", filetype::zx_z80, system::zxspectrum128k, true);
-    this->Items.Add("Silkworm", "silkworm_zx128k.z80", filetype::zx_z80, system::zxspectrum128k, true);
-    this->Items.Add("Hello World!", "atom_hello.txt", filetype::text, system::acorn_atom, true);
-    this->Items.Add("Text Mode Test", "atom_alnum_test.txt", filetype::text, system::acorn_atom, true);
-    this->Items.Add("Graphics Mode Test", "atom_graphics_test.txt", filetype::text, system::acorn_atom, true);
-    this->Items.Add("Atomic Memory Checker", "atom_memcheck.txt", filetype::text, system::acorn_atom, true);
-    this->Items.Add("Keyboard Joystick Test", "atom_kbdjoytest.txt", filetype::text, system::acorn_atom, true);
-    this->Items.Add("AtoMMC Joystick Test", "atom_mmcjoytest.txt", filetype::text, system::acorn_atom, true);
-    this->Items.Add("Jet Set Willy", "JSW.TAP", filetype::atom_tap, system::acorn_atom, true);
-    this->Items.Add("Atomic Chuckie Egg", "CCHUCK.TAP", filetype::atom_tap, system::acorn_atom, true);
-    this->Items.Add("Hard Hat Harry", "hardhatharry.tap", filetype::atom_tap, system::acorn_atom, true);
-    this->Items.Add("Jet Set Miner", "cjetsetminer.tap", filetype::atom_tap, system::acorn_atom, true);
-    this->Items.Add("Dormann 6502 Test", "dormann6502.tap", filetype::atom_tap, system::acorn_atom, true);
-    this->Items.Add("Boulderdash", "boulderdash_c64.tap", filetype::c64_tap, system::any_c64, true);
-    this->Items.Add("Zaxxon", "zaxxon_c64.tap", filetype::c64_tap, system::any_c64, true);
-    this->Items.Add("Arkanoid", "arkanoid_c64.tap", filetype::c64_tap, system::any_c64, true);
-    this->Items.Add("Dig Dug", "digdug_c64.tap", filetype::c64_tap, system::any_c64, true);
-    this->Items.Add("IK+", "ikplus_c64.tap", filetype::c64_tap, system::any_c64, true);
+    this->loadCatalog();
+}
+
+//------------------------------------------------------------------------------
+void
+FileLoader::loadCatalog() {
+    const char* filename = "catalog.txt";
+    auto fetchCatalog = [this, filename]() {
+        Buffer buf;
+        if (this->archive && this->archive->Extract(filename, buf)) {
+            this->onCatalogLoaded(buf.Data(), buf.Size());
+            return;
+        }
+        if (this->LocalDir.IsValid()) {
+            StringBuilder strBuilder;
+            strBuilder.Format(1024, "%s/%s", this->LocalDir.AsCStr(), filename);
+            mapped_file file;
+            if (file.open(strBuilder.AsCStr())) {
+                this->onCatalogLoaded(file.ptr(), file.size());
+                return;
+            }
+        }
+        StringBuilder strBuilder;
+        strBuilder.Format(128, "kcc:%s", filename);
+        IO::Load(strBuilder.GetString(),
+            [this](IO::LoadResult ioResult) {
+                this->onCatalogLoaded(ioResult.Data.Data(), ioResult.Data.Size());
+            },
+            [](const URL& url, IOStatus::Code ioStatus) {
+                Log::Warn("FileLoader: failed to load '%s'\n", url.AsCStr());
+            });
+    };
+    if (this->archive) {
+        this->archive->WhenReady(fetchCatalog);
+    }
+    else {
+        fetchCatalog();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+FileLoader::onCatalogLoaded(const uint8_t* data, int size) {
+    if (!this->Catalog.parse((const char*)data, size)) {
+        Log::Warn("FileLoader: skipped malformed lines in catalog\n");
+    }
+    // Items are in the same order as catalog entries
+    this->Items.Clear();
+    this->Items.Reserve(this->Catalog.num_entries());
+    for (int i = 0; i < this->Catalog.num_entries(); i++) {
+        const catalog::entry& e = this->Catalog.at(i);
+        Item item(e.name, e.filename, e.type, e.compat, e.start_addr, e.exec_addr);
+        item.EnableJoystick = e.joystick;
+        this->Items.Add(item);
+    }
 }
 
 //------------------------------------------------------------------------------
 void
 FileLoader::Discard() {
     o_assert(this == pointer);
+    this->archive = nullptr;
     pointer = nullptr;
 }
 
@@ -154,30 +98,14 @@ FileLoader::LoadAndStart(const Item& item) {
 //------------------------------------------------------------------------------
 void
 FileLoader::LoadTape(const Item& item) {
-    StringBuilder strBuilder;
-    strBuilder.Format(128, "kcc:%s", item.Filename.AsCStr());
-    this->Url = strBuilder.GetString();
-    this->State = Loading;
-    IO::Load(strBuilder.GetString(),
-        // load succeeded
-        [this, item](IO::LoadResult ioResult) {
-            this->FileData = std::move(ioResult.Data);
-            this->Info = parseHeader(this->FileData, item);
-            this->State = Ready;
-            quickload(this->emu, this->Info, this->FileData, false);
-        },
-        // load failed
-        [this](const URL& url, IOStatus::Code ioStatus) {
-            this->State = Failed;
-            this->FailedStatus = ioStatus;
-        });
+    this->load(item, false);
 }
 
 //------------------------------------------------------------------------------
 bool
 FileLoader::Copy() {
     if (Ready == this->State) {
-        this->quickload(this->emu, this->Info, this->FileData, false);
+        this->quickload(this->emu, this->Info, this->fileData(), this->fileSize(), false);
         return true;
     }
     else {
@@ -189,7 +117,7 @@ FileLoader::Copy() {
 bool
 FileLoader::Start() {
     if (Ready == this->State) {
-        this->quickload(this->emu, this->Info, this->FileData, true);
+        this->quickload(this->emu, this->Info, this->fileData(), this->fileSize(), true);
         return true;
     }
     else {
@@ -207,17 +135,45 @@ FileLoader::ObtainTextBuffer() {
 //------------------------------------------------------------------------------
 void
 FileLoader::load(const Item& item, bool autostart) {
+    this->State = Loading;
+    if (this->archive) {
+        this->archive->WhenReady([this, item, autostart]() {
+            this->fetch(item, autostart);
+        });
+    }
+    else {
+        this->fetch(item, autostart);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+FileLoader::fetch(const Item& item, bool autostart) {
+    Buffer buf;
+    if (this->archive && this->archive->Extract(item.Filename.AsCStr(), buf)) {
+        this->Url = item.Filename;
+        this->localFile.close();
+        this->FileData = std::move(buf);
+        this->Info = parseHeader(this->FileData.Data(), this->FileData.Size(), item);
+        this->State = Ready;
+        quickload(this->emu, this->Info, this->FileData.Data(), this->FileData.Size(), autostart);
+        return;
+    }
+    if (this->LocalDir.IsValid()) {
+        this->loadLocal(item, autostart);
+        return;
+    }
     StringBuilder strBuilder;
     strBuilder.Format(128, "kcc:%s", item.Filename.AsCStr());
     this->Url = strBuilder.GetString();
-    this->State = Loading;
     IO::Load(strBuilder.GetString(),
         // load succeeded
         [this, item, autostart](IO::LoadResult ioResult) {
+            this->localFile.close();
             this->FileData = std::move(ioResult.Data);
-            this->Info = parseHeader(this->FileData, item);
+            this->Info = parseHeader(this->FileData.Data(), this->FileData.Size(), item);
             this->State = Ready;
-            quickload(this->emu, this->Info, this->FileData, autostart);
+            quickload(this->emu, this->Info, this->FileData.Data(), this->FileData.Size(), autostart);
         },
         // load failed
         [this](const URL& url, IOStatus::Code ioStatus) {
@@ -226,13 +182,60 @@ FileLoader::load(const Item& item, bool autostart) {
         });
 }
 
+//------------------------------------------------------------------------------
+void
+FileLoader::loadLocal(const Item& item, bool autostart) {
+    StringBuilder strBuilder;
+    strBuilder.Format(1024, "%s/%s", this->LocalDir.AsCStr(), item.Filename.AsCStr());
+    this->Url = strBuilder.GetString();
+    this->FileData.Clear();
+    if (!this->localFile.open(strBuilder.AsCStr())) {
+        this->State = Failed;
+        this->FailedStatus = IOStatus::NotFound;
+        return;
+    }
+    this->Info = parseHeader(this->localFile.ptr(), this->localFile.size(), item);
+    if (filetype::text == this->Info.Type) {
+        // text is handed over to the keyboard playback as buffer
+        this->FileData.Add(this->localFile.ptr(), this->localFile.size());
+        this->localFile.close();
+    }
+    this->State = Ready;
+    quickload(this->emu, this->Info, this->fileData(), this->fileSize(), autostart);
+}
+
+//------------------------------------------------------------------------------
+const uint8_t*
+FileLoader::fileData() const {
+    return this->localFile.is_open() ? this->localFile.ptr() : this->FileData.Data();
+}
+
+//------------------------------------------------------------------------------
+int
+FileLoader::fileSize() const {
+    return this->localFile.is_open() ? this->localFile.size() : this->FileData.Size();
+}
+
 //------------------------------------------------------------------------------
 FileLoader::FileInfo
-FileLoader::parseHeader(const Buffer& data, const Item& item) {
+FileLoader::parseHeader(const uint8_t* data, int size, const Item& item) {
     FileInfo info;
     info.Filename = item.Filename;
     info.EnableJoystick = item.EnableJoystick;
-    if (filetype::none == item.Type) {
+    // only files which are not in the catalog need their type guessed
+    filetype knownType = filetype::none;
+    const int catalogIndex = this->Catalog.find(item.Filename.AsCStr());
+    if (catalogIndex >= 0) {
+        knownType = this->Catalog.at(catalogIndex).type;
+    }
+    else if (this->archive && this->archive->Contains(item.Filename.AsCStr())) {
+        const class archive& pak = this->archive->Archive;
+        knownType = pak.type(pak.find(item.Filename.AsCStr()));
+    }
+    if ((filetype::none == item.Type) && (filetype::none != knownType)) {
+        info.Type = knownType;
+    }
+    else if (filetype::none == item.Type) {
         // guess the file type
         StringBuilder strb(item.Filename);
         if (strb.Contains(".TXT") || strb.Contains(".txt")) {
@@ -266,6 +269,9 @@ FileLoader::parseHeader(const Buffer& data, const Item& item) {
         else if (strb.Contains(".SNA") || strb.Contains(".sna")) {
             info.Type = filetype::cpc_sna;
         }
+        else if (strb.Contains(".DSK") || strb.Contains(".dsk")) {
+            info.Type = filetype::cpc_dsk;
+        }
         else {
             info.Type = filetype::raw;
         }
@@ -273,11 +279,10 @@ FileLoader::parseHeader(const Buffer& data, const Item& item) {
     else {
         info.Type = item.Type;
     }
-    if (data.Empty()) {
+    if ((nullptr == data) || (0 == size)) {
         return info;
     }
-    const uint8_t* start = data.Data();
-    const uint8_t* ptr = start;
+    const uint8_t* ptr = data;
     if ((filetype::kc_tap == info.Type) || (filetype::kcc == info.Type)) {
         if (filetype::kc_tap == info.Type) {
             ptr = (const uint8_t*)&(((kctap_header*)ptr)->kcc);
@@ -320,6 +325,10 @@ FileLoader::parseHeader(const Buffer& data, const Item& item) {
         const cpctap_header* hdr = (const cpctap_header*) ptr;
         info.Name = String((const char*)hdr->name, 0, 16);
     }
+    else if (filetype::cpc_dsk == info.Type) {
+        info.Name = item.Filename;
+        info.RequiredSystem = system::cpc6128;
+    }
     else if (filetype::atom_tap == info.Type) {
         const atomtap_header* hdr = (const atomtap_header*) ptr;
         info.Name = String((const char*)hdr->name, 0, 16);
@@ -330,7 +339,7 @@ FileLoader::parseHeader(const Buffer& data, const Item& item) {
 
 //------------------------------------------------------------------------------
 void
-FileLoader::quickload(yakc* emu, const FileInfo& info, const Buffer& data, bool autostart) {
+FileLoader::quickload(yakc* emu, const FileInfo& info, const uint8_t* data, int size, bool autostart) {
     enum State newState = FileLoader::Waiting;
     if (filetype::text == info.Type) {
         // do nothing for text files, this will be checked
@@ -339,9 +348,19 @@ FileLoader::quickload(yakc* emu, const FileInfo& info, const Buffer& data, bool
     }
     else {
         o_assert(info.Filename.IsValid());
-        if (emu->filesystem.add(info.Filename.AsCStr(), data.Data(), data.Size())) {
-            emu->quickload(info.Filename.AsCStr(), info.Type, autostart);
+        // the data is only needed during the quickload call, no need to copy
+        if (emu->filesystem.add(info.Filename.AsCStr(), data, size, filesystem::ownership::borrow)) {
+            const bool loaded = emu->quickload(info.Filename.AsCStr(), info.Type, autostart);
             emu->enable_joystick(true);
+            if (loaded && autostart && (filetype::cpc_dsk == info.Type)) {
+                // disc images are started by typing the boot command
+                const char* cmd = emu->disc_boot_cmd();
+                if (cmd) {
+                    Buffer buf;
+                    buf.Add((const uint8_t*)cmd, strlen(cmd)+1);
+                    Keyboard::self->StartPlayback(std::move(buf));
+                }
+            }
             if (!autostart) {
                 newState = FileLoader::Ready;
             }
@@ -381,11 +400,11 @@ FileLoader::LoadAuto(const Item& item, const uint8_t* data, int size) {
 /* FIXME!
     this->FileData.Clear();
     this->FileData.Add(data, size);
-    this->Info = this->parseHeader(this->FileData, item);
+    this->Info = this->parseHeader(this->FileData.Data(), this->FileData.Size(), item);
     this->State = FileLoader::Ready;
     if (int(this->Info.RequiredSystem) & int(this->emu->model)) {
         if (filetype_quickloadable(this->Info.Type)) {
-            this->quickload(this->emu, this->Info, this->FileData, true);
+            this->quickload(this->emu, this->Info, this->FileData.Data(), this->FileData.Size(), true);
             return true;
         }
         else if (filetype::none != this->Info.Type){
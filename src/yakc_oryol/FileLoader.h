@@ -3,12 +3,19 @@
 /**
     @class YAKC::FileLoader
     @brief helper class to load KCC files
+
+    The quickloadable software titles are described by the data-driven
+    catalog in 'catalog.txt' (see YAKC::catalog), which is loaded once
+    in Setup().
 */
 #include "yakc/yakc.h"
+#include "yakc/util/mapped_file.h"
+#include "yakc/util/catalog.h"
 #include "Core/String/String.h"
 #include "Core/Containers/Array.h"
 #include "IO/IO.h"
 #include "yakc_oryol/Keyboard.h"
+#include "yakc_oryol/ArchiveLoader.h"
 
 namespace YAKC {
 
@@ -19,9 +26,9 @@ public:
     /// a load item
     struct Item {
         Item(const char* n, const char* fn, filetype t, system compat, bool enableJoystick=false) :
-            Name(n), Filename(fn), Type(t), Compat(compat), OptStartAddr(0), OptExecAddr(0), EnableJoystick(true) {};
+            Name(n), Filename(fn), Type(t), Compat(compat), OptStartAddr(0), OptExecAddr(0), EnableJoystick(enableJoystick) {};
         Item(const char* n, const char* fn, filetype t, system compat, uint16_t startAddr, uint16_t execAddr) :
-            Name(n), Filename(fn), Type(t), Compat(compat), OptStartAddr(startAddr), OptExecAddr(execAddr) {};
+            Name(n), Filename(fn), Type(t), Compat(compat), OptStartAddr(startAddr), OptExecAddr(execAddr), EnableJoystick(false) {};
         Oryol::String Name;
         Oryol::String Filename;
         filetype Type;
@@ -30,7 +37,9 @@ public:
         uint16_t OptExecAddr;
         bool EnableJoystick;
     };
-    /// available items
+    /// the software catalog
+    catalog Catalog;
+    /// available items, in the same order as the catalog entries
     Oryol::Array<Item> Items;
 
     /// loading state
@@ -56,9 +65,11 @@ public:
     Oryol::IOStatus::Code FailedStatus = Oryol::IOStatus::OK;
     /// flips to true if externally provided data available
     bool ExtFileReady = false;
+    /// if valid, files are mapped from this local directory instead of loaded via HTTP
+    Oryol::String LocalDir;
 
-    /// setup the file loader object
-    void Setup(yakc& emu);
+    /// setup the file loader object, files are extracted from the archive if possible
+    void Setup(yakc& emu, ArchiveLoader* archive=nullptr);
     /// discard the loader object
     void Discard();
     /// automatically load and start a loader item
@@ -79,15 +90,30 @@ public:
     Oryol::Buffer&& ObtainTextBuffer();
 
     /// get file info from loaded file data
-    FileInfo parseHeader(const Oryol::Buffer& data, const Item& item);
+    FileInfo parseHeader(const uint8_t* data, int size, const Item& item);
     /// quickload the provided file data
-    static void quickload(yakc* emu, const FileInfo& info, const Oryol::Buffer& data, bool autostart);
+    static void quickload(yakc* emu, const FileInfo& info, const uint8_t* data, int size, bool autostart);
     /// start loading, and then call quickload
     void load(const Item& item, bool autostart);
+    /// get file from archive, local directory or web server
+    void fetch(const Item& item, bool autostart);
+    /// load the software catalog
+    void loadCatalog();
+    /// called when the catalog has been loaded
+    void onCatalogLoaded(const uint8_t* data, int size);
+    /// map file from local directory, and then call quickload
+    void loadLocal(const Item& item, bool autostart);
 
     Oryol::Buffer FileData;
+    /// pointer to loaded file data (either mapped or in FileData)
+    const uint8_t* fileData() const;
+    /// size of loaded file data
+    int fileSize() const;
+
 private:
     yakc* emu = nullptr;
+    ArchiveLoader* archive = nullptr;
+    mapped_file localFile;
 };
 
 } // namespace YAKC
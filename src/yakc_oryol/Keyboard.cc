@@ -271,9 +271,6 @@ Keyboard::HandleInput() {
                 this->cur_pad_joy |= joystick::down;
             }
         }
-        if (!this->playbackBuffer.Empty()) {
-            this->handleTextPlayback();
-        }
         this->emu->on_joystick(this->cur_kbd_joy, this->cur_pad_joy);
     }
 }
@@ -281,37 +278,9 @@ Keyboard::HandleInput() {
 //------------------------------------------------------------------------------
 void
 Keyboard::StartPlayback(Buffer&& buf) {
-    this->playbackBuffer = std::move(buf);
-    this->playbackPos = 0;
-}
-
-//------------------------------------------------------------------------------
-void
-Keyboard::handleTextPlayback() {
-    int charDelay = 10;
-    if (this->emu->is_system(system::any_c64)) {
-        // C64 has a very fast input scanning routine
-        charDelay = 2;
-    }
-    if (this->playbackPos < this->playbackBuffer.Size()) {
-        // give the system some time between characters
-        if (this->playbackCounter-- == 0) {
-            this->playbackCounter = charDelay;
-            // feed the next character from buffer
-            // filter out unwanted characters and convert
-            uint8_t chr = this->playbackBuffer.Data()[this->playbackPos++];
-            if (chr != '\t' && chr != '\r') {
-                if (chr == '\n') {
-                    chr = 0x0D;
-                }
-                this->emu->on_ascii(chr);
-            }
-        }
-    }
-    else {
-        this->playbackBuffer.Clear();
-        this->playbackPos = 0;
-    }
+    // text is fed into the emulator in emulated time, so that pasting
+    // is independent from the host frame rate
+    this->emu->paste.start(buf.Data(), buf.Size());
 }
 
 } // namespace YAKC
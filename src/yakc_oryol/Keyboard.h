@@ -19,23 +19,14 @@ public:
     void Discard();
     /// handle keyboard input, call this once per frame
     void HandleInput();
-    /// set a text stream for playback
+    /// set a text stream for playback (see YAKC::paste)
     void StartPlayback(Oryol::Buffer&& buffer);
 
-    /// handle text playback (called from HandleInput)
-    void handleTextPlayback();
-
     bool hasInputFocus = true;
     yakc* emu = nullptr;
     uint8_t cur_kbd_joy = 0;
     uint8_t cur_pad_joy = 0;
     Oryol::Input::CallbackId callbackId = 0;
-
-    int playbackCounter = 0;
-    bool playbackFlipFlop = 0;
-    int playbackPos = 0;
-    uint8_t playbackChar = 0;
-    Oryol::Buffer playbackBuffer;
 };
 
 } // namespace YAKC
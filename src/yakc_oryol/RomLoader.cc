@@ -0,0 +1,216 @@
+//------------------------------------------------------------------------------
+//  RomLoader.cc
+//------------------------------------------------------------------------------
+#include "RomLoader.h"
+#include "IO/IO.h"
+#include "Core/String/StringBuilder.h"
+
+using namespace Oryol;
+
+namespace YAKC {
+
+static_assert(rom_images::num_roms <= 64, "RomLoader: ROM bitmasks too small");
+
+//------------------------------------------------------------------------------
+void
+RomLoader::Setup(yakc& emu_, const String& localDir_, ArchiveLoader* archive_) {
+    this->emu = &emu_;
+    this->localDir = localDir_;
+    this->archive = archive_;
+}
+
+//------------------------------------------------------------------------------
+void
+RomLoader::Discard() {
+    this->requests.Clear();
+    this->deferred.Clear();
+    for (auto& file : this->localFiles) {
+        file.close();
+    }
+    this->emu = nullptr;
+    this->archive = nullptr;
+}
+
+//------------------------------------------------------------------------------
+void
+RomLoader::Prepare(system model, os_rom os, std::function<void()> onReady) {
+    o_assert_dbg(this->emu);
+    request req;
+    req.numRoms = rom_images::required(model, os, req.roms, rom_images::max_required);
+    req.onReady = onReady;
+    if (0 == req.numRoms) {
+        Log::Warn("RomLoader: no ROM manifest entry for system\n");
+        return;
+    }
+    for (int i = 0; i < req.numRoms; i++) {
+        this->startLoad(req.roms[i]);
+    }
+    this->requests.Add(std::move(req));
+    this->updateRequests();
+}
+
+//------------------------------------------------------------------------------
+void
+RomLoader::Load(rom_images::rom rom, std::function<void()> onLoaded) {
+    request req;
+    req.roms[0] = rom;
+    req.numRoms = 1;
+    req.onReady = onLoaded;
+    this->startLoad(rom);
+    this->requests.Add(std::move(req));
+    this->updateRequests();
+}
+
+//------------------------------------------------------------------------------
+void
+RomLoader::Defer(rom_images::rom rom, std::function<void()> onLoaded) {
+    request req;
+    req.roms[0] = rom;
+    req.numRoms = 1;
+    req.onReady = onLoaded;
+    this->deferred.Add(std::move(req));
+}
+
+//------------------------------------------------------------------------------
+void
+RomLoader::LoadDeferred() {
+    for (auto& req : this->deferred) {
+        this->Load(req.roms[0], std::move(req.onReady));
+    }
+    this->deferred.Clear();
+}
+
+//------------------------------------------------------------------------------
+bool
+RomLoader::IsLoading() const {
+    return 0 != this->inFlight;
+}
+
+//------------------------------------------------------------------------------
+bool
+RomLoader::IsFailed(rom_images::rom rom) const {
+    return 0 != (this->failed & (uint64_t(1)<<rom));
+}
+
+//------------------------------------------------------------------------------
+void
+RomLoader::startLoad(rom_images::rom rom) {
+    const uint64_t mask = uint64_t(1)<<rom;
+    if (roms.has(rom) || (this->inFlight & mask)) {
+        return;
+    }
+    this->failed &= ~mask;
+    this->inFlight |= mask;
+    if (this->archive) {
+        this->archive->WhenReady([this, rom]() {
+            this->fetch(rom);
+        });
+    }
+    else {
+        this->fetch(rom);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+RomLoader::fetch(rom_images::rom rom) {
+    Buffer buf;
+    if (this->archive && this->archive->Extract(rom_images::filename(rom), buf)) {
+        this->onLoadFinished(rom, buf.Data(), buf.Size());
+    }
+    else if (this->localDir.IsValid()) {
+        StringBuilder strBuilder;
+        strBuilder.Format(1024, "%s/%s", this->localDir.AsCStr(), rom_images::filename(rom));
+        mapped_file& file = this->localFiles[rom];
+        if (file.open(strBuilder.AsCStr())) {
+            this->onLoadFinished(rom, file.ptr(), file.size());
+        }
+        else {
+            this->onLoadFinished(rom, nullptr, 0);
+        }
+    }
+    else {
+        StringBuilder strBuilder;
+        strBuilder.Format(128, "rom:%s", rom_images::filename(rom));
+        IO::Load(strBuilder.GetString(),
+            [this, rom](IO::LoadResult ioRes) {
+                this->onLoadFinished(rom, ioRes.Data.Data(), ioRes.Data.Size());
+            },
+            [this, rom](const URL& url, IOStatus::Code ioStatus) {
+                this->onLoadFinished(rom, nullptr, 0);
+            });
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+RomLoader::onLoadFinished(rom_images::rom rom, const uint8_t* data, int size) {
+    const uint64_t mask = uint64_t(1)<<rom;
+    this->inFlight &= ~mask;
+    bool ok = false;
+    if (data && (size == rom_images::expected_size(rom))) {
+        if (this->localFiles[rom].is_open()) {
+            ok = this->emu->add_rom_ref(rom, data, size);
+        }
+        else {
+            ok = this->emu->add_rom(rom, data, size);
+        }
+        if (!ok) {
+            Log::Warn("RomLoader: ROM '%s' doesn't match known-good hash %08X\n",
+                rom_images::filename(rom), rom_images::known_hash(rom));
+        }
+    }
+    if (!ok) {
+        Log::Warn("RomLoader: failed to load ROM '%s'\n", rom_images::filename(rom));
+        this->localFiles[rom].close();
+        this->failed |= mask;
+    }
+    this->updateRequests();
+}
+
+//------------------------------------------------------------------------------
+bool
+RomLoader::isReady(const rom_images::rom* roms_, int numRoms) const {
+    for (int i = 0; i < numRoms; i++) {
+        if (!roms.has(roms_[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+RomLoader::isFailed(const rom_images::rom* roms_, int numRoms) const {
+    for (int i = 0; i < numRoms; i++) {
+        if (this->IsFailed(roms_[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+void
+RomLoader::updateRequests() {
+    // NOTE: callbacks may issue new requests, so first collect the
+    // finished requests, and then call the callbacks
+    Array<std::function<void()>> ready;
+    for (int i = this->requests.Size() - 1; i >= 0; i--) {
+        request& req = this->requests[i];
+        if (this->isReady(req.roms, req.numRoms)) {
+            if (req.onReady) {
+                ready.Add(std::move(req.onReady));
+            }
+            this->requests.Erase(i);
+        }
+        else if (this->isFailed(req.roms, req.numRoms)) {
+            this->requests.Erase(i);
+        }
+    }
+    for (auto& fn : ready) {
+        fn();
+    }
+}
+
+} // namespace YAKC
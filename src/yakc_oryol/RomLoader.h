@@ -0,0 +1,74 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class YAKC::RomLoader
+    @brief load ROM images on demand
+
+    The RomLoader uses the ROM manifest in rom_images to only fetch
+    the ROMs which are required to boot a specific system, and which
+    haven't been loaded yet. All missing ROMs of a system are requested
+    in parallel, and the completion callback is called when all of
+    them are available and have the expected size.
+
+    ROMs are extracted from the packed archive if it contains them,
+    otherwise, if a local directory is set, ROMs are memory-mapped from
+    there instead of loaded through the 'rom:' assign.
+*/
+#include "yakc/yakc.h"
+#include "yakc/util/mapped_file.h"
+#include "yakc_oryol/ArchiveLoader.h"
+#include "Core/String/String.h"
+#include "Core/Containers/Array.h"
+#include <functional>
+
+namespace YAKC {
+
+class RomLoader {
+public:
+    /// setup the ROM loader
+    void Setup(yakc& emu, const Oryol::String& localDir, ArchiveLoader* archive=nullptr);
+    /// discard the ROM loader
+    void Discard();
+    /// load missing ROMs of a system, call onReady when all are available
+    void Prepare(system model, os_rom os, std::function<void()> onReady);
+    /// load a single ROM if missing, call onLoaded when available
+    void Load(rom_images::rom rom, std::function<void()> onLoaded);
+    /// register a ROM to be loaded on the next call to LoadDeferred()
+    void Defer(rom_images::rom rom, std::function<void()> onLoaded);
+    /// start loading deferred ROMs
+    void LoadDeferred();
+    /// return true if any ROMs are currently loading
+    bool IsLoading() const;
+    /// return true if a ROM failed to load
+    bool IsFailed(rom_images::rom rom) const;
+
+private:
+    /// start loading a ROM
+    void startLoad(rom_images::rom rom);
+    /// get ROM data from archive, local directory or web server
+    void fetch(rom_images::rom rom);
+    /// called when a ROM load has finished (success or failure)
+    void onLoadFinished(rom_images::rom rom, const uint8_t* data, int size);
+    /// check pending requests and call their callbacks
+    void updateRequests();
+    /// check if all ROMs of a request are available
+    bool isReady(const rom_images::rom* roms, int numRoms) const;
+    /// check if any ROM of a request has failed
+    bool isFailed(const rom_images::rom* roms, int numRoms) const;
+
+    struct request {
+        rom_images::rom roms[rom_images::max_required];
+        int numRoms = 0;
+        std::function<void()> onReady;
+    };
+    Oryol::Array<request> requests;
+    Oryol::Array<request> deferred;
+    uint64_t inFlight = 0;      // bitmask of ROMs currently loading
+    uint64_t failed = 0;        // bitmask of ROMs which failed to load
+    yakc* emu = nullptr;
+    ArchiveLoader* archive = nullptr;
+    Oryol::String localDir;
+    mapped_file localFiles[rom_images::num_roms];
+};
+
+} // namespace YAKC
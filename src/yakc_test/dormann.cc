@@ -0,0 +1,216 @@
+//------------------------------------------------------------------------------
+//  yakc_test dormann.cc
+//
+//  Headless runner for Klaus Dormann's 6502 functional and decimal mode
+//  tests on a bare 6502 with 64 KByte RAM (no system emulator):
+//
+//  yakc_dormann [-dir path]
+//  yakc_dormann -bin file -load addr -start addr -success addr [-error addr]
+//
+//  Without -bin, the Atom tape image files/dormann6502.tap is run. This
+//  build prints through the Atom OS routines OSWRCH ($FFF4) and waits
+//  for a key through OSRDCH ($FFE3) after success or failure, both are
+//  stubbed out, and the printed text tells whether all tests passed.
+//
+//  With -bin, a raw test binary (e.g. 6502_functional_test.bin or
+//  6502_decimal_test.bin) is loaded at the load address and started at
+//  the start address. The tests end in a 'jmp *' or 'bne *' self-loop,
+//  which has passed if it is at the success address (and the optional
+//  error byte is zero). All addresses are hex.
+//
+//  The runner reports the executed cycles, host time and the effective
+//  emulated clock rate, exit code 0 means passed.
+//------------------------------------------------------------------------------
+#include "yakc/util/core.h"
+#include "yakc/util/mapped_file.h"
+#include "yakc/util/filetypes.h"
+#include "chips/m6502.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+
+using namespace YAKC;
+
+static const uint16_t oswrch_addr = 0xFFF4;
+static const uint16_t osrdch_addr = 0xFFE3;
+static const uint32_t exec_ticks = 10000;
+static const uint64_t max_ticks = 1000000000ULL;
+
+struct machine {
+    m6502_t cpu;
+    uint8_t ram[0x10000];
+    bool atom_os = false;       // stub the Atom OS output and input routines
+    bool stopped = false;       // self-loop or wait for input
+    uint16_t last_pc = 0;
+    uint16_t stop_pc = 0;
+    std::string output;
+};
+static machine m;
+
+//------------------------------------------------------------------------------
+static uint64_t
+tick(uint64_t pins, void* user_data) {
+    machine* sys = (machine*) user_data;
+    const uint16_t addr = M6502_GET_ADDR(pins);
+    if (pins & M6502_SYNC) {
+        // opcode fetch, check for self-loops and OS calls
+        if (addr == sys->last_pc) {
+            sys->stopped = true;
+            sys->stop_pc = addr;
+        }
+        else if (sys->atom_os && (addr == oswrch_addr)) {
+            const char c = (char) sys->cpu.state.A;
+            if ((c == '\n') || ((c >= 0x20) && (c < 0x7F))) {
+                sys->output += c;
+            }
+        }
+        else if (sys->atom_os && (addr == osrdch_addr)) {
+            sys->stopped = true;
+            sys->stop_pc = addr;
+        }
+        sys->last_pc = addr;
+    }
+    if (pins & M6502_RW) {
+        M6502_SET_DATA(pins, sys->ram[addr]);
+    }
+    else {
+        sys->ram[addr] = M6502_GET_DATA(pins);
+    }
+    return pins;
+}
+
+//------------------------------------------------------------------------------
+static bool
+load_atom_tap(const mapped_file& file, uint16_t& out_start) {
+    if (file.size() <= (int)sizeof(atomtap_header)) {
+        return false;
+    }
+    const atomtap_header* hdr = (const atomtap_header*) file.ptr();
+    const uint16_t load_addr = hdr->load_addr;
+    const int length = hdr->length;
+    if ((length < 6) || (((int)sizeof(atomtap_header) + length) > file.size())) {
+        return false;
+    }
+    const uint8_t* data = file.ptr() + sizeof(atomtap_header);
+    for (int i = 0; i < length; i++) {
+        m.ram[(load_addr + i) & 0xFFFF] = data[i];
+    }
+    // the last 6 bytes are the NMI, RESET and IRQ vectors for $FFFA
+    memcpy(&m.ram[0xFFFA], data + length - 6, 6);
+    // the OS routines just return
+    m.ram[oswrch_addr] = 0x60;
+    m.ram[osrdch_addr] = 0x60;
+    m.atom_os = true;
+    out_start = hdr->exec_addr;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+static bool
+load_bin(const mapped_file& file, uint16_t load_addr) {
+    if ((load_addr + file.size()) > 0x10000) {
+        return false;
+    }
+    memcpy(&m.ram[load_addr], file.ptr(), file.size());
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int
+main(int argc, const char** argv) {
+    std::string dir = "files";
+    const char* bin = nullptr;
+    int load_addr = -1, start_addr = -1, success_addr = -1, error_addr = -1;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* val = (i + 1) < argc ? argv[i + 1] : nullptr;
+        if (!val) {
+            fprintf(stderr, "missing value for '%s'\n", arg);
+            return 10;
+        }
+        if (0 == strcmp(arg, "-dir"))           { dir = val; }
+        else if (0 == strcmp(arg, "-bin"))      { bin = val; }
+        else if (0 == strcmp(arg, "-load"))     { load_addr = (int) strtol(val, nullptr, 16); }
+        else if (0 == strcmp(arg, "-start"))    { start_addr = (int) strtol(val, nullptr, 16); }
+        else if (0 == strcmp(arg, "-success"))  { success_addr = (int) strtol(val, nullptr, 16); }
+        else if (0 == strcmp(arg, "-error"))    { error_addr = (int) strtol(val, nullptr, 16); }
+        else {
+            fprintf(stderr, "unknown argument '%s'\n", arg);
+            return 10;
+        }
+        i++;
+    }
+    func = default_ext_funcs();
+
+    // load the test program
+    mapped_file file;
+    uint16_t start = 0;
+    if (bin) {
+        if ((load_addr < 0) || (start_addr < 0) || (success_addr < 0)) {
+            fprintf(stderr, "-bin needs -load, -start and -success\n");
+            return 10;
+        }
+        if (!file.open(bin) || !load_bin(file, (uint16_t)load_addr)) {
+            fprintf(stderr, "failed to load '%s'\n", bin);
+            return 10;
+        }
+        start = (uint16_t) start_addr;
+    }
+    else {
+        const std::string path = dir + "/dormann6502.tap";
+        if (!file.open(path.c_str()) || !load_atom_tap(file, start)) {
+            fprintf(stderr, "failed to load '%s'\n", path.c_str());
+            return 10;
+        }
+    }
+
+    // start through the reset vector
+    const uint8_t reset_vec[2] = { m.ram[0xFFFC], m.ram[0xFFFD] };
+    m.ram[0xFFFC] = start & 0xFF;
+    m.ram[0xFFFD] = start >> 8;
+    m6502_desc_t desc = { };
+    desc.tick_cb = tick;
+    desc.user_data = &m;
+    m6502_init(&m.cpu, &desc);
+    m.last_pc = 0xFFFF;
+
+    uint64_t ticks = 0;
+    bool started = false;
+    const auto t0 = std::chrono::steady_clock::now();
+    while (!m.stopped && (ticks < max_ticks)) {
+        ticks += m6502_exec(&m.cpu, exec_ticks);
+        if (!started) {
+            // restore the test's own reset vector once running
+            m.ram[0xFFFC] = reset_vec[0];
+            m.ram[0xFFFD] = reset_vec[1];
+            started = true;
+        }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const double host_secs = std::chrono::duration<double>(t1 - t0).count();
+
+    bool passed = false;
+    if (m.atom_os) {
+        passed = m.stopped && (std::string::npos != m.output.find("All tests completed"));
+        printf("%s", m.output.c_str());
+    }
+    else if (m.stopped) {
+        passed = (m.stop_pc == success_addr) && ((error_addr < 0) || (0 == m.ram[error_addr]));
+    }
+    if (!m.stopped) {
+        printf("\ntimeout after %llu cycles, PC=%04X\n", (unsigned long long)ticks, m.cpu.state.PC);
+    }
+    else {
+        printf("\nstopped at PC=%04X", m.stop_pc);
+        if (error_addr >= 0) {
+            printf(", error byte=%02X", m.ram[error_addr]);
+        }
+        printf("\n");
+    }
+    printf("%s: %llu cycles in %.3f s host time (%.2f MHz)\n",
+        passed ? "PASSED" : "FAILED", (unsigned long long)ticks, host_secs,
+        (host_secs > 0.0) ? (ticks / host_secs / 1000000.0) : 0.0);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,336 @@
+//------------------------------------------------------------------------------
+//  yakc_test wlorenz.cc
+//
+//  Headless runner for the Wolfgang Lorenz C64 emulator test suite:
+//
+//  yakc_wlorenz [-dir path] [-test name] [-jobs N] [-timeout secs]
+//
+//  Each test is loaded into a freshly booted C64 and started with
+//  SYS 2049. A test has passed when it jumps into the BASIC LOAD
+//  routine at $E16F to chain-load the next test, and has failed when
+//  it waits for a key through GETIN ($FFE4) after printing an error.
+//  Both addresses are trapped, the error message is read from screen
+//  RAM.
+//
+//  Since the emulator is a process-wide singleton, tests are run in
+//  parallel by starting worker processes, each worker runs every N-th
+//  test. The results are printed in the same format as
+//  misc/c64_wlorenz.md, sorted by test name.
+//------------------------------------------------------------------------------
+#include "yakc/yakc.h"
+#include "yakc/util/breadboard.h"
+#include "yakc/util/mapped_file.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#define popen _popen
+#define pclose _pclose
+#else
+#include <dirent.h>
+#endif
+
+using namespace YAKC;
+
+static const int frame_us = 20000;
+static const int pass_trap_id = 1;      // BASIC LOAD, chain-load the next test
+static const int fail_trap_id = 2;      // GETIN, wait for key after an error
+static const uint16_t pass_addr = 0xE16F;
+static const uint16_t fail_addr = 0xFFE4;
+
+struct options {
+    std::string dir = "files/wlorenz";
+    const char* test = nullptr;
+    int jobs = 0;
+    int worker = -1;
+    int timeout = 600;
+};
+
+struct result {
+    std::string name;
+    std::string status;
+    std::vector<std::string> lines;
+};
+
+static yakc emu;
+static mapped_file rom_files[3];
+
+//------------------------------------------------------------------------------
+static bool
+load_roms(const std::string& files_dir) {
+    const rom_images::rom types[3] = { rom_images::c64_basic, rom_images::c64_char, rom_images::c64_kernalv3 };
+    for (int i = 0; i < 3; i++) {
+        const std::string path = files_dir + "/" + rom_images::filename(types[i]);
+        if (!rom_files[i].open(path.c_str()) || !emu.add_rom_ref(types[i], rom_files[i].ptr(), rom_files[i].size())) {
+            fprintf(stderr, "failed to load ROM '%s'\n", path.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+static std::vector<std::string>
+list_tests(const std::string& dir) {
+    std::vector<std::string> names;
+    #if defined(_WIN32)
+    WIN32_FIND_DATAA data;
+    HANDLE h = FindFirstFileA((dir + "\\*").c_str(), &data);
+    if (h != INVALID_HANDLE_VALUE) {
+        do {
+            if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+                names.push_back(data.cFileName);
+            }
+        }
+        while (FindNextFileA(h, &data));
+        FindClose(h);
+    }
+    #else
+    DIR* d = opendir(dir.c_str());
+    if (d) {
+        while (struct dirent* ent = readdir(d)) {
+            if (ent->d_name[0] != '.') {
+                names.push_back(ent->d_name);
+            }
+        }
+        closedir(d);
+    }
+    #endif
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+//------------------------------------------------------------------------------
+/// read the text screen, starting after the line with the SYS command
+static std::vector<std::string>
+read_screen(const std::string& name) {
+    std::vector<std::string> lines;
+    for (int y = 0; y < 25; y++) {
+        std::string line;
+        for (int x = 0; x < 40; x++) {
+            uint8_t c = mem_rd(board.mem, 0x0400 + y*40 + x) & 0x7F;
+            if (c == 0) {
+                c = '@';
+            }
+            else if (c < 27) {
+                c = 'A' + c - 1;
+            }
+            else if ((c >= 64) || (c == 28) || (c == 30) || (c == 31)) {
+                c = ' ';
+            }
+            line += char(c);
+        }
+        line.erase(line.find_last_not_of(' ') + 1);
+        if (line.find("SYS 2049") != std::string::npos) {
+            lines.clear();
+        }
+        else if (!line.empty()) {
+            lines.push_back(line);
+        }
+    }
+    // drop the test name printed by the test itself
+    std::string upper_name = name;
+    std::transform(upper_name.begin(), upper_name.end(), upper_name.begin(), ::toupper);
+    if (!lines.empty() && (lines[0].find(upper_name.substr(upper_name.find_first_not_of(' '))) != std::string::npos)) {
+        lines.erase(lines.begin());
+    }
+    return lines;
+}
+
+//------------------------------------------------------------------------------
+static result
+run_test(const options& opts, const std::string& name) {
+    result res;
+    res.name = name;
+    mapped_file file;
+    if (!file.open((opts.dir + "/" + name).c_str())) {
+        res.status = "MISSING";
+        return res;
+    }
+    emu.poweron(YAKC::system::c64_pal);
+    emu.filesystem.add(name.c_str(), file.ptr(), file.size(), filesystem::ownership::borrow);
+    if (!emu.quickload(name.c_str(), filetype::raw, false)) {
+        res.status = "LOAD FAILED";
+        emu.poweroff();
+        emu.filesystem.reset();
+        return res;
+    }
+    const char* cmd = "SYS 2049\n";
+    emu.paste.start((const uint8_t*)cmd, (int)strlen(cmd));
+    while (emu.paste.is_active()) {
+        emu.exec(frame_us);
+    }
+    m6502_set_trap(board.m6502, pass_trap_id, pass_addr);
+    m6502_set_trap(board.m6502, fail_trap_id, fail_addr);
+    res.status = "TIMEOUT";
+    const int max_frames = (opts.timeout * 1000000) / frame_us;
+    for (int i = 0; i < max_frames; i++) {
+        emu.exec(frame_us);
+        if (board.m6502->trap_id == pass_trap_id) {
+            res.status = "OK";
+            break;
+        }
+        else if (board.m6502->trap_id == fail_trap_id) {
+            res.status = "FAIL";
+            break;
+        }
+    }
+    if (res.status != "OK") {
+        res.lines = read_screen(name);
+    }
+    emu.poweroff();
+    emu.filesystem.reset();
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/// write a result as a single tab-separated line (worker to main process)
+static void
+write_result(const result& res) {
+    printf("%s\t%s", res.name.c_str(), res.status.c_str());
+    for (const auto& line : res.lines) {
+        printf("\t%s", line.c_str());
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+//------------------------------------------------------------------------------
+static bool
+parse_result(const char* str, result& res) {
+    std::string line(str);
+    line.erase(line.find_last_not_of("\r\n") + 1);
+    std::vector<std::string> fields;
+    size_t pos = 0;
+    while (true) {
+        const size_t tab = line.find('\t', pos);
+        fields.push_back(line.substr(pos, tab - pos));
+        if (tab == std::string::npos) {
+            break;
+        }
+        pos = tab + 1;
+    }
+    if (fields.size() < 2) {
+        return false;
+    }
+    res.name = fields[0];
+    res.status = fields[1];
+    res.lines.assign(fields.begin() + 2, fields.end());
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int
+main(int argc, const char** argv) {
+    options opts;
+    std::string files_dir = "files";
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* val = (i + 1) < argc ? argv[i + 1] : nullptr;
+        if (!val) {
+            fprintf(stderr, "missing value for '%s'\n", arg);
+            return 10;
+        }
+        if (0 == strcmp(arg, "-dir"))           { files_dir = val; }
+        else if (0 == strcmp(arg, "-test"))     { opts.test = val; }
+        else if (0 == strcmp(arg, "-jobs"))     { opts.jobs = atoi(val); }
+        else if (0 == strcmp(arg, "-worker"))   { opts.worker = atoi(val); }
+        else if (0 == strcmp(arg, "-timeout"))  { opts.timeout = atoi(val); }
+        else {
+            fprintf(stderr, "unknown argument '%s'\n", arg);
+            return 10;
+        }
+        i++;
+    }
+    opts.dir = files_dir + "/wlorenz";
+    if (opts.test) {
+        opts.jobs = 1;
+    }
+    else if (opts.jobs <= 0) {
+        opts.jobs = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+
+    std::vector<std::string> tests;
+    if (opts.test) {
+        tests.push_back(opts.test);
+    }
+    else {
+        tests = list_tests(opts.dir);
+    }
+    if (tests.empty()) {
+        fprintf(stderr, "no tests found in '%s'\n", opts.dir.c_str());
+        return 10;
+    }
+
+    std::vector<result> results;
+    if ((opts.worker >= 0) || (1 == opts.jobs)) {
+        emu.init(default_ext_funcs());
+        if (!load_roms(files_dir)) {
+            return 10;
+        }
+        emu.auto_warp = YAKC::system::none;
+        // each test boots the OS from a cold start
+        emu.bootcache.enabled = false;
+        for (int i = 0; i < (int)tests.size(); i++) {
+            if ((opts.worker < 0) || ((i % opts.jobs) == opts.worker)) {
+                result res = run_test(opts, tests[i]);
+                if (opts.worker >= 0) {
+                    write_result(res);
+                }
+                else {
+                    results.push_back(res);
+                }
+            }
+        }
+        if (opts.worker >= 0) {
+            return 0;
+        }
+    }
+    else {
+        // start worker processes, and collect their results
+        std::vector<FILE*> workers;
+        for (int i = 0; i < opts.jobs; i++) {
+            char cmd[2048];
+            snprintf(cmd, sizeof(cmd), "\"%s\" -dir \"%s\" -jobs %d -worker %d -timeout %d",
+                argv[0], files_dir.c_str(), opts.jobs, i, opts.timeout);
+            FILE* fp = popen(cmd, "r");
+            if (!fp) {
+                fprintf(stderr, "failed to start worker process\n");
+                return 10;
+            }
+            workers.push_back(fp);
+        }
+        char line[4096];
+        for (FILE* fp : workers) {
+            while (fgets(line, sizeof(line), fp)) {
+                result res;
+                if (parse_result(line, res)) {
+                    results.push_back(res);
+                }
+            }
+            pclose(fp);
+        }
+        std::sort(results.begin(), results.end(), [](const result& a, const result& b) {
+            return a.name < b.name;
+        });
+    }
+
+    int num_ok = 0;
+    for (const auto& res : results) {
+        printf("- %s: %s\n", res.name.substr(res.name.find_first_not_of(' ')).c_str(), res.status.c_str());
+        for (const auto& line : res.lines) {
+            printf("    %s\n", line.c_str());
+        }
+        if (res.status == "OK") {
+            num_ok++;
+        }
+    }
+    printf("\n%d of %d tests OK\n", num_ok, (int)tests.size());
+    return (num_ok == (int)tests.size()) ? 0 : 1;
+}
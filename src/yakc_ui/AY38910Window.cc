@@ -3,12 +3,18 @@
 //------------------------------------------------------------------------------
 #include "AY38910Window.h"
 #include "IMUI/IMUI.h"
+#include "yakc_ui/Util.h"
 #include "yakc/util/breadboard.h"
 
 using namespace Oryol;
 
 namespace YAKC {
 
+static const char* const ayRegs[] = {
+    "R0", "R1", "R2", "R3", "R4", "R5", "R6", "R7",
+    "R8", "R9", "R10", "R11", "R12", "R13", "R14", "R15", "Latch"
+};
+
 //------------------------------------------------------------------------------
 void
 AY38910Window::Setup(yakc& emu) {
@@ -65,6 +71,7 @@ AY38910Window::Draw(yakc& emu) {
             ImGui::Text("Env Volume:    %02X", ay->env.shape_state);
             ImGui::Text("Env Hold/Holding: %s/%s", ay->env.shape_hold?"ON ":"OFF", ay->env.shape_holding?"ON ":"OFF");
         }
+        Util::DrawIOStats(emu, chip::ay38910, 17, ayRegs);
     }
     ImGui::End();
     return this->Visible;
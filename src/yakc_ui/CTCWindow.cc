@@ -3,6 +3,7 @@
 //------------------------------------------------------------------------------
 #include "CTCWindow.h"
 #include "IMUI/IMUI.h"
+#include "yakc_ui/Util.h"
 #include "Core/String/StringBuilder.h"
 #include "yakc/util/breadboard.h"
 
@@ -10,6 +11,8 @@ using namespace Oryol;
 
 namespace YAKC {
 
+static const char* const ctcRegs[] = { "CTC 0", "CTC 1", "CTC 2", "CTC 3" };
+
 //------------------------------------------------------------------------------
 void
 CTCWindow::Setup(yakc& emu) {
@@ -53,6 +56,7 @@ CTCWindow::Draw(yakc& emu) {
                 }
             }
         }
+        Util::DrawIOStats(emu, chip::z80ctc, 4, ctcRegs);
     }
     ImGui::End();
     return this->Visible;
@@ -31,6 +31,7 @@ DebugWindow::Draw(yakc& emu) {
                 this->drawMainContent(emu, z80_pc(board.z80), 48);
                 ImGui::Separator();
                 this->drawControls(emu);
+                this->drawRewindControls(emu);
             }
         }
         else {
@@ -40,6 +41,7 @@ DebugWindow::Draw(yakc& emu) {
                 this->drawMainContent(emu, board.m6502->state.PC, 48);
                 ImGui::Separator();
                 this->drawControls(emu);
+                this->drawRewindControls(emu);
             }
         }
     }
@@ -205,12 +207,60 @@ DebugWindow::drawControls(yakc& emu) {
     }
 }
 
+//------------------------------------------------------------------------------
+void
+DebugWindow::drawRewindControls(yakc& emu) {
+    bool rec = emu.rewinder.is_enabled();
+    if (ImGui::Checkbox("Rec", &rec)) {
+        if (rec) {
+            emu.rewinder.enable(emu.snapshot_size());
+        }
+        else {
+            emu.rewinder.disable();
+        }
+    }
+    if (ImGui::IsItemHovered()) { ImGui::SetTooltip("record snapshots for reverse debugging"); }
+    ImGui::SameLine();
+    if (rec) {
+        if (board.dbg.break_stopped()) {
+            if (ImGui::Button("<Step")) {
+                emu.step_back();
+            }
+            if (ImGui::IsItemHovered()) { ImGui::SetTooltip("step back one instruction"); }
+            ImGui::SameLine();
+            if (board.dbg.breakpoint_enabled()) {
+                if (ImGui::Button("<BP")) {
+                    emu.run_back_to(board.dbg.breakpoint_addr());
+                }
+                if (ImGui::IsItemHovered()) { ImGui::SetTooltip("run back to previous breakpoint hit"); }
+                ImGui::SameLine();
+            }
+            if (ImGui::Button("<Cont")) {
+                emu.reverse_continue();
+            }
+            if (ImGui::IsItemHovered()) { ImGui::SetTooltip("run back to breakpoint or oldest snapshot"); }
+            ImGui::SameLine();
+        }
+        ImGui::Text("%d (%.1f MB)", emu.rewinder.num_snapshots(), emu.rewinder.num_bytes() / (1024.0f * 1024.0f));
+    }
+    else {
+        // the memory cap is applied when recording starts
+        int max_mbytes = emu.rewinder.max_bytes / (1024 * 1024);
+        ImGui::PushItemWidth(96);
+        if (ImGui::SliderInt("##maxmem", &max_mbytes, 1, 256, "%.0f MB")) {
+            emu.rewinder.max_bytes = max_mbytes * 1024 * 1024;
+        }
+        if (ImGui::IsItemHovered()) { ImGui::SetTooltip("max snapshot memory"); }
+        ImGui::PopItemWidth();
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 DebugWindow::drawMainContent(yakc& emu, uint16_t start_addr, int num_lines) {
     YAKC_ASSERT(board.mem);
 
-    ImGui::BeginChild("##scrolling", ImVec2(0, -1 * (ImGui::GetFrameHeightWithSpacing()+4)));
+    ImGui::BeginChild("##scrolling", ImVec2(0, -1 * (2 * ImGui::GetFrameHeightWithSpacing()+4)));
 
     ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0,0));
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(1,1));
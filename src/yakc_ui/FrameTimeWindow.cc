@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+//  FrameTimeWindow.cc
+//------------------------------------------------------------------------------
+#include "FrameTimeWindow.h"
+#include "IMUI/IMUI.h"
+#include "yakc_ui/UI.h"
+
+using namespace Oryol;
+
+namespace YAKC {
+
+//------------------------------------------------------------------------------
+void
+FrameTimeWindow::Setup(yakc& emu) {
+    this->setName("Frame Timing");
+    board.profiler.enable();
+}
+
+//------------------------------------------------------------------------------
+bool
+FrameTimeWindow::Draw(yakc& emu) {
+    ImGui::SetNextWindowSize(ImVec2(380, 300), ImGuiSetCond_Once);
+    if (ImGui::Begin(this->title.AsCStr(), &this->Visible)) {
+        bool enabled = board.profiler.is_enabled();
+        if (ImGui::Checkbox("On", &enabled)) {
+            if (enabled) {
+                board.profiler.enable();
+            }
+            else {
+                board.profiler.disable();
+            }
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Clear")) {
+            board.profiler.clear();
+        }
+        ImGui::SameLine();
+        ImGui::Text("%d frames", board.profiler.num_valid_frames());
+        this->drawPercentiles();
+        this->drawPlot();
+    }
+    ImGui::End();
+    if (!this->Visible) {
+        board.profiler.disable();
+    }
+    return this->Visible;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameTimeWindow::drawPercentiles() {
+    const profiler& prof = board.profiler;
+    ImGui::Columns(4, "##percentiles", false);
+    ImGui::Text("Section"); ImGui::NextColumn();
+    ImGui::Text("p50"); ImGui::NextColumn();
+    ImGui::Text("p95"); ImGui::NextColumn();
+    ImGui::Text("p99"); ImGui::NextColumn();
+    ImGui::Separator();
+    for (int i = 0; i <= profiler::num_sections; i++) {
+        if (ImGui::Selectable(profiler::name(i), this->curSection == i, ImGuiSelectableFlags_SpanAllColumns)) {
+            this->curSection = i;
+        }
+        ImGui::NextColumn();
+        ImGui::Text("%.2fms", prof.percentile(i, 50.0f) / 1000.0f); ImGui::NextColumn();
+        ImGui::Text("%.2fms", prof.percentile(i, 95.0f) / 1000.0f); ImGui::NextColumn();
+        ImGui::Text("%.2fms", prof.percentile(i, 99.0f) / 1000.0f); ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+}
+
+//------------------------------------------------------------------------------
+void
+FrameTimeWindow::drawPlot() {
+    const profiler& prof = board.profiler;
+    float values[profiler::num_frames];
+    const int num = prof.num_valid_frames();
+    for (int i = 0; i < num; i++) {
+        values[i] = prof.frame_time(this->curSection, i) / 1000.0f;
+    }
+    const float max_ms = prof.percentile(profiler::num_sections, 100.0f) / 1000.0f;
+    ImGui::PlotHistogram("##frames", values, num, 0, profiler::name(this->curSection),
+        0.0f, max_ms > 0.0f ? max_ms : 1.0f, ImVec2(-1, 80));
+}
+
+} // namespace YAKC
@@ -0,0 +1,28 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class FrameTimeWindow
+    @brief per-frame breakdown of the emulation host time
+*/
+#include "yakc_ui/WindowBase.h"
+
+namespace YAKC {
+
+class FrameTimeWindow : public WindowBase {
+    OryolClassDecl(FrameTimeWindow);
+public:
+    /// setup the window
+    virtual void Setup(yakc& emu) override;
+    /// draw method
+    virtual bool Draw(yakc& emu) override;
+
+    /// draw the percentile table
+    void drawPercentiles();
+    /// draw the frame time plot of the selected section
+    void drawPlot();
+
+    /// the section shown in the plot (num_sections for the frame total)
+    int curSection = profiler::num_sections;
+};
+
+} // namespace YAKC
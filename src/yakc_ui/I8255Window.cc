@@ -3,6 +3,7 @@
 //------------------------------------------------------------------------------
 #include "I8255Window.h"
 #include "IMUI/IMUI.h"
+#include "yakc_ui/Util.h"
 #include "yakc_ui/UI.h"
 #include "yakc/util/breadboard.h"
 
@@ -10,6 +11,8 @@ using namespace Oryol;
 
 namespace YAKC {
 
+static const char* const ppiRegs[] = { "Port A", "Port B", "Port C", "Control" };
+
 //------------------------------------------------------------------------------
 void
 I8255Window::Setup(yakc& emu) {
@@ -152,6 +155,7 @@ I8255Window::Draw(yakc& emu) {
                 }
             }
         }
+        Util::DrawIOStats(emu, chip::i8255, 4, ppiRegs);
     }
     ImGui::End();
     return this->Visible;
@@ -20,6 +20,20 @@ InfoWindow::Draw(yakc& emu) {
     ImGui::SetNextWindowSize(ImVec2(540, 440), ImGuiSetCond_Once);
     if (ImGui::Begin(this->title.AsCStr(), &this->Visible)) {
         ImGui::TextWrapped("%s", emu.system_info());
+        if (ImGui::CollapsingHeader("Memory Usage")) {
+            const memory_report mem = emu.memory_usage();
+            ImGui::Text("System state:   %7d KB", mem.sys_state / 1024);
+            ImGui::Text("Pixel buffer:   %7d KB", mem.pixel_buffer / 1024);
+            ImGui::Text("ROM images:     %7d KB", mem.rom_images / 1024);
+            ImGui::Text("Filesystem:     %7d KB", mem.filesystem / 1024);
+            ImGui::Text("Rewinder:       %7d KB", mem.rewinder / 1024);
+            ImGui::Text("Boot cache:     %7d KB", mem.bootcache / 1024);
+            ImGui::Text("Memory stats:   %7d KB", mem.memstats / 1024);
+            ImGui::Text("I/O stats:      %7d KB", mem.iostats / 1024);
+            ImGui::Text("Coverage:       %7d KB", mem.coverage / 1024);
+            ImGui::Text("Idle detection: %7d KB", mem.idle / 1024);
+            ImGui::Text("Total:          %7d KB", mem.total / 1024);
+        }
     }
     ImGui::End();
     return this->Visible;
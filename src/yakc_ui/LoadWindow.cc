@@ -54,6 +54,7 @@ LoadWindow::Draw(yakc& emu) {
                 "CPC SNA",
                 "CPC TAP",
                 "CPC BIN",
+                "CPC DSK",
                 "ATOM TAP",
                 "C64 TAP",
                 "TEXT",
@@ -63,7 +64,7 @@ LoadWindow::Draw(yakc& emu) {
             if (ImGui::Combo("File Type", &curFileType, typeNames, int(filetype::num))) {
                 // reparse loaded data
                 FileLoader::Item item("", ldr.Info.Filename.AsCStr(), (filetype)curFileType, system::any);
-                ldr.Info = ldr.parseHeader(ldr.FileData, item);
+                ldr.Info = ldr.parseHeader(ldr.fileData(), ldr.fileSize(), item);
             }
             ImGui::Text("Filename: %s", ldr.Info.Filename.AsCStr());
             ImGui::Text("Name:     %s", ldr.Info.Name.AsCStr());
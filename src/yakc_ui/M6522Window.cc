@@ -3,6 +3,7 @@
 //------------------------------------------------------------------------------
 #include "M6522Window.h"
 #include "IMUI/IMUI.h"
+#include "yakc_ui/Util.h"
 #include "yakc/util/breadboard.h"
 
 using namespace Oryol;
@@ -41,6 +42,7 @@ M6522Window::Draw(yakc& emu) {
             ImGui::Text("T1:      0x%04X", via.t1);
             ImGui::Text("T2:      0x%04X", via.t2);
         }
+        Util::DrawIOStats(emu, chip::m6522, 16);
     }
     ImGui::End();
     return this->Visible;
@@ -3,6 +3,7 @@
 //------------------------------------------------------------------------------
 #include "M6526Window.h"
 #include "IMUI/IMUI.h"
+#include "yakc_ui/Util.h"
 
 using namespace Oryol;
 
@@ -112,6 +113,7 @@ M6526Window::Draw(yakc& emu) {
         if (ImGui::CollapsingHeader("Timer B", "#timer_b", true, true)) {
             drawTimerState(1, &this->CIA->tb);
         }
+        Util::DrawIOStats(emu, (this->CIA == board.m6526_2) ? chip::m6526_2 : chip::m6526, 16);
     }
     ImGui::End();
     return this->Visible;
@@ -165,6 +165,7 @@ M6569Window::Draw(yakc& emu) {
                 if (ImGui::IsItemHovered()) { ImGui::SetTooltip("Run to next badline"); }
             }
         }
+        Util::DrawIOStats(emu, chip::m6569, 64);
     }
     ImGui::End();
     return this->Visible;
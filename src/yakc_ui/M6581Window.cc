@@ -3,6 +3,7 @@
 //------------------------------------------------------------------------------
 #include "M6581Window.h"
 #include "IMUI/IMUI.h"
+#include "yakc_ui/Util.h"
 #include "yakc/util/breadboard.h"
 
 using namespace Oryol;
@@ -73,6 +74,7 @@ M6581Window::Draw(yakc& emu) {
                 ImGui::Text("Vhp: %d", f.v_hp);
             }
         }
+        Util::DrawIOStats(emu, chip::m6581, 32);
     }
     ImGui::End();
     return this->Visible;
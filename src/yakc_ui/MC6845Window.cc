@@ -10,6 +10,8 @@ using namespace Oryol;
 
 namespace YAKC {
 
+static const char* const crtcRegs[] = { "Select", "Write", "Status", "Read" };
+
 //------------------------------------------------------------------------------
 void
 MC6845Window::Setup(yakc& emu) {
@@ -119,6 +121,7 @@ MC6845Window::Draw(yakc& emu) {
                 if (ImGui::IsItemHovered()) { ImGui::SetTooltip("Run to end of vsync"); }
             }
         }
+        Util::DrawIOStats(emu, chip::mc6845, 4, crtcRegs);
     }
     ImGui::End();
     return this->Visible;
@@ -0,0 +1,186 @@
+//------------------------------------------------------------------------------
+//  MemoryHeatmapWindow.cc
+//------------------------------------------------------------------------------
+#include "MemoryHeatmapWindow.h"
+#include "IMUI/IMUI.h"
+#include "Core/String/StringBuilder.h"
+#include "yakc_ui/UI.h"
+#include <math.h>
+
+using namespace Oryol;
+
+namespace YAKC {
+
+static const int cell_size = 4;
+static const int cells_per_row = 64;
+static const int num_rows = memstats::num_cells / cells_per_row;
+static const int bytes_per_row = cells_per_row << memstats::cell_shift;
+static const int left_padding = 40;
+static const int page_size = 0x400;
+
+//------------------------------------------------------------------------------
+MemoryHeatmapWindow::~MemoryHeatmapWindow() {
+    if (this->image) {
+        IMUI::FreeImage(this->image);
+        this->image = nullptr;
+    }
+    if (this->texture.IsValid()) {
+        Gfx::DestroyResources(this->texLabel);
+        this->texture.Invalidate();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+MemoryHeatmapWindow::Setup(yakc& emu) {
+    this->setName("Memory Heatmap");
+    emu.memstats.clear();
+    emu.memstats.enable();
+
+    // one texel per heatmap cell, scaled up without filtering
+    auto texSetup = TextureSetup::Empty2D(cells_per_row, num_rows, 1, PixelFormat::RGBA8, Usage::Stream);
+    texSetup.Sampler.MinFilter = TextureFilterMode::Nearest;
+    texSetup.Sampler.MagFilter = TextureFilterMode::Nearest;
+    texSetup.Sampler.WrapU = TextureWrapMode::ClampToEdge;
+    texSetup.Sampler.WrapV = TextureWrapMode::ClampToEdge;
+    this->texLabel = Gfx::PushResourceLabel();
+    this->texture = Gfx::CreateResource(texSetup);
+    Gfx::PopResourceLabel();
+    this->texUpdateAttrs.NumFaces = 1;
+    this->texUpdateAttrs.NumMipMaps = 1;
+    this->texUpdateAttrs.Sizes[0][0] = sizeof(this->pixels);
+    this->image = IMUI::AllocImage();
+    IMUI::BindImage(this->image, this->texture);
+}
+
+//------------------------------------------------------------------------------
+bool
+MemoryHeatmapWindow::Draw(yakc& emu) {
+    ImGui::SetNextWindowSize(ImVec2(left_padding + cells_per_row*cell_size + 24, 560), ImGuiSetCond_Once);
+    if (ImGui::Begin(this->title.AsCStr(), &this->Visible)) {
+        bool enabled = emu.memstats.is_enabled();
+        if (ImGui::Checkbox("On", &enabled)) {
+            if (enabled) {
+                emu.memstats.enable();
+            }
+            else {
+                emu.memstats.disable();
+            }
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Clear")) {
+            emu.memstats.clear();
+        }
+        ImGui::SameLine();
+        ImGui::PushItemWidth(64);
+        ImGui::SliderInt("Decay", &emu.memstats.decay_shift, 0, 8);
+        if (ImGui::IsItemHovered()) { ImGui::SetTooltip("counters lose 1/2^N per frame (0: no decay)"); }
+        ImGui::PopItemWidth();
+        ImGui::PushItemWidth(-1);
+        ImGui::Combo("##view", &this->curView, "Writes(R) Reads(G) Execs(B)\0Reads\0Writes\0Execs\0\0");
+        ImGui::PopItemWidth();
+        this->drawHeatmap(emu);
+        if (ImGui::CollapsingHeader("Page Statistics")) {
+            this->drawPageTable(emu);
+        }
+    }
+    ImGui::End();
+    if (!this->Visible) {
+        emu.memstats.disable();
+    }
+    return this->Visible;
+}
+
+//------------------------------------------------------------------------------
+static float
+intensity(uint32_t count, float max_log) {
+    if ((count == 0) || (max_log <= 0.0f)) {
+        return 0.0f;
+    }
+    return 0.25f + 0.75f * (logf(float(count) + 1.0f) / max_log);
+}
+
+//------------------------------------------------------------------------------
+void
+MemoryHeatmapWindow::drawHeatmap(yakc& emu) {
+    const memstats& stats = emu.memstats;
+    StringBuilder strBuilder;
+    ImDrawList* l = ImGui::GetWindowDrawList();
+    const ImVec2 canvas_pos = ImGui::GetCursorScreenPos();
+
+    // address labels
+    for (int row = 0; row < num_rows; row += 8) {
+        strBuilder.Format(32, "%04X", row * bytes_per_row);
+        l->AddText(ImVec2(canvas_pos.x, canvas_pos.y + row*cell_size - 4), UI::CanvasTextColor, strBuilder.AsCStr());
+    }
+
+    // heatmap cells, as one image
+    this->updateTexture(stats);
+    ImGui::SetCursorScreenPos(ImVec2(canvas_pos.x + left_padding, canvas_pos.y));
+    ImGui::Image(this->image, ImVec2(float(cells_per_row*cell_size), float(num_rows*cell_size)));
+
+    // tooltip with cell counters under mouse
+    const ImVec2 mouse_pos = ImGui::GetMousePos();
+    const int mx = int(mouse_pos.x - canvas_pos.x - left_padding);
+    const int my = int(mouse_pos.y - canvas_pos.y);
+    if (ImGui::IsWindowHovered() &&
+        (mx >= 0) && (mx < cells_per_row*cell_size) &&
+        (my >= 0) && (my < num_rows*cell_size))
+    {
+        const int cell = (my / cell_size) * cells_per_row + (mx / cell_size);
+        const int addr = cell << memstats::cell_shift;
+        ImGui::SetTooltip("%04X..%04X\nreads:  %u\nwrites: %u\nexecs:  %u",
+            addr, addr + (1<<memstats::cell_shift) - 1,
+            stats.count(memstats::read, cell),
+            stats.count(memstats::write, cell),
+            stats.count(memstats::exec, cell));
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+MemoryHeatmapWindow::updateTexture(const memstats& stats) {
+    float max_log[memstats::num_access_types];
+    for (int i = 0; i < memstats::num_access_types; i++) {
+        max_log[i] = logf(float(stats.max_count((memstats::access)i)) + 1.0f);
+    }
+    for (int cell = 0; cell < memstats::num_cells; cell++) {
+        const float r = intensity(stats.count(memstats::write, cell), max_log[memstats::write]);
+        const float g = intensity(stats.count(memstats::read, cell), max_log[memstats::read]);
+        const float b = intensity(stats.count(memstats::exec, cell), max_log[memstats::exec]);
+        ImVec4 color;
+        switch (this->curView) {
+            case reads:     color = ImVec4(g, g, g, 1.0f); break;
+            case writes:    color = ImVec4(r, r, r, 1.0f); break;
+            case execs:     color = ImVec4(b, b, b, 1.0f); break;
+            default:        color = ImVec4(r, g, b, 1.0f); break;
+        }
+        this->pixels[cell] = ImGui::ColorConvertFloat4ToU32(color);
+    }
+    Gfx::UpdateTexture(this->texture, this->pixels, this->texUpdateAttrs);
+}
+
+//------------------------------------------------------------------------------
+void
+MemoryHeatmapWindow::drawPageTable(yakc& emu) {
+    const memstats& stats = emu.memstats;
+    ImGui::Columns(4, "##pages", false);
+    ImGui::Text("Page"); ImGui::NextColumn();
+    ImGui::Text("Reads"); ImGui::NextColumn();
+    ImGui::Text("Writes"); ImGui::NextColumn();
+    ImGui::Text("Execs"); ImGui::NextColumn();
+    ImGui::Separator();
+    for (int addr = 0; addr < 0x10000; addr += page_size) {
+        const uint32_t r = stats.sum(memstats::read, addr, page_size);
+        const uint32_t w = stats.sum(memstats::write, addr, page_size);
+        const uint32_t x = stats.sum(memstats::exec, addr, page_size);
+        const ImVec4& c = (r|w|x) ? UI::DefaultTextColor : UI::DisabledColor;
+        ImGui::TextColored(c, "%04X", addr); ImGui::NextColumn();
+        ImGui::TextColored(c, "%u", r); ImGui::NextColumn();
+        ImGui::TextColored(c, "%u", w); ImGui::NextColumn();
+        ImGui::TextColored(c, "%u", x); ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+}
+
+} // namespace YAKC
@@ -0,0 +1,47 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class MemoryHeatmapWindow
+    @brief visualize CPU memory access statistics as heatmap
+*/
+#include "yakc_ui/WindowBase.h"
+#include "Gfx/Gfx.h"
+
+namespace YAKC {
+
+class MemoryHeatmapWindow : public WindowBase {
+    OryolClassDecl(MemoryHeatmapWindow);
+public:
+    /// destructor
+    virtual ~MemoryHeatmapWindow();
+    /// setup the window
+    virtual void Setup(yakc& emu) override;
+    /// draw method
+    virtual bool Draw(yakc& emu) override;
+
+    /// draw the heatmap of the 64 KByte address space
+    void drawHeatmap(yakc& emu);
+    /// draw the per-page statistics table
+    void drawPageTable(yakc& emu);
+
+    /// what to display in the heatmap
+    enum view {
+        all = 0,    // writes: red, reads: green, executes: blue
+        reads,
+        writes,
+        execs,
+    };
+    int curView = all;
+
+private:
+    /// update the heatmap texture from the memory access counters
+    void updateTexture(const memstats& stats);
+
+    Oryol::Id texture;
+    Oryol::ResourceLabel texLabel;
+    Oryol::ImageDataAttrs texUpdateAttrs;
+    void* image = nullptr;      // ImTextureID
+    uint32_t pixels[memstats::num_cells];
+};
+
+} // namespace YAKC
@@ -3,12 +3,15 @@
 //------------------------------------------------------------------------------
 #include "PIOWindow.h"
 #include "IMUI/IMUI.h"
+#include "yakc_ui/Util.h"
 #include "yakc_ui/UI.h"
 
 using namespace Oryol;
 
 namespace YAKC {
 
+static const char* const pioRegs[] = { "A data", "B data", "A ctrl", "B ctrl" };
+
 static const int offset = 128;
 
 //------------------------------------------------------------------------------
@@ -77,6 +80,7 @@ PIOWindow::Draw(yakc& emu) {
         if (ImGui::CollapsingHeader("PIO B", "#pio_b", true, true)) {
             pioStatus(this->PIO, Z80PIO_PORT_B);
         }
+        Util::DrawIOStats(emu, (this->PIO == board.z80pio_2) ? chip::z80pio_2 : chip::z80pio, 4, pioRegs);
     }
     ImGui::End();
     return this->Visible;
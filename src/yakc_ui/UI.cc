@@ -5,6 +5,8 @@
 #include "Util.h"
 #include "MemoryWindow.h"
 #include "MemoryMapWindow.h"
+#include "MemoryHeatmapWindow.h"
+#include "FrameTimeWindow.h"
 #include "DebugWindow.h"
 #include "DisasmWindow.h"
 #include "PIOWindow.h"
@@ -47,8 +49,9 @@ ImU32 UI::CanvasLineColor;
 
 //------------------------------------------------------------------------------
 void
-UI::Setup(yakc& emu, Audio* audio_) {
+UI::Setup(yakc& emu, Audio* audio_, RomLoader* romLoader_, ArchiveLoader* archive) {
     this->audio = audio_;
+    this->romLoader = romLoader_;
     IMUI::Setup();
     ImGui::StyleColorsDark();
     auto& style = ImGui::GetStyle();
@@ -64,10 +67,20 @@ UI::Setup(yakc& emu, Audio* audio_) {
     InvalidOpCodeColor = ImVec4(1.0f, 0.0f, 1.0f, 1.0f);
     CanvasTextColor = 0xFFFFFFFF;
     CanvasLineColor = 0xFFFFFFFF;
-    this->FileLoader.Setup(emu);
+    this->FileLoader.Setup(emu, archive);
     this->curTime = Clock::Now();
 }
 
+//------------------------------------------------------------------------------
+void
+UI::boot(yakc& emu, system m, os_rom os) {
+    yakc* emuPtr = &emu;
+    this->romLoader->Prepare(m, os, [emuPtr, m, os]() {
+        emuPtr->poweroff();
+        emuPtr->poweron(m, os);
+    });
+}
+
 //------------------------------------------------------------------------------
 void
 UI::Discard() {
@@ -174,125 +187,74 @@ UI::OnFrame(yakc& emu) {
             if (ImGui::BeginMenu(model)) {
                 if (ImGui::BeginMenu("System")) {
                     if (ImGui::BeginMenu("VEB MPM")) {
-                        if (emu.check_roms(system::kc85_2, os_rom::caos_hc900)) {
-                            if (ImGui::MenuItem("KC85/2 (HC900-CAOS)")) {
-                                emu.poweroff();
-                                emu.poweron(system::kc85_2, os_rom::caos_hc900);
-                            }
+                        if (ImGui::MenuItem("KC85/2 (HC900-CAOS)")) {
+                            this->boot(emu, system::kc85_2, os_rom::caos_hc900);
                         }
-                        if (emu.check_roms(system::kc85_2, os_rom::caos_2_2)) {
-                            if (ImGui::MenuItem("KC85/2 (HC-CAOS 2.2)")) {
-                                emu.poweroff();
-                                emu.poweron(system::kc85_2, os_rom::caos_2_2);
-                            }
+                        if (ImGui::MenuItem("KC85/2 (HC-CAOS 2.2)")) {
+                            this->boot(emu, system::kc85_2, os_rom::caos_2_2);
                         }
-                        if (emu.check_roms(system::kc85_3, os_rom::caos_3_1)) {
-                            if (ImGui::MenuItem("KC85/3 (HC-CAOS 3.1)")) {
-                                emu.poweroff();
-                                emu.poweron(system::kc85_3, os_rom::caos_3_1);
-                            }
+                        if (ImGui::MenuItem("KC85/3 (HC-CAOS 3.1)")) {
+                            this->boot(emu, system::kc85_3, os_rom::caos_3_1);
                         }
-                        if (emu.check_roms(system::kc85_3, os_rom::caos_3_4)) {
-                            if (ImGui::MenuItem("KC85/3 (HC-CAOS 3.4i)")) {
-                                emu.poweroff();
-                                emu.poweron(system::kc85_3, os_rom::caos_3_4);
-                            }
+                        if (ImGui::MenuItem("KC85/3 (HC-CAOS 3.4i)")) {
+                            this->boot(emu, system::kc85_3, os_rom::caos_3_4);
                         }
-                        if (emu.check_roms(system::kc85_4, os_rom::caos_4_2)) {
-                            if (ImGui::MenuItem("KC85/4 (KC-CAOS 4.2)")) {
-                                emu.poweroff();
-                                emu.poweron(system::kc85_4, os_rom::caos_4_2);
-                            }
+                        if (ImGui::MenuItem("KC85/4 (KC-CAOS 4.2)")) {
+                            this->boot(emu, system::kc85_4, os_rom::caos_4_2);
                         }
-                        if (emu.check_roms(system::kccompact)) {
-                            if (ImGui::MenuItem("KC Compact (CPC clone)")) {
-                                emu.poweroff();
-                                emu.poweron(system::kccompact);
-                            }
+                        if (ImGui::MenuItem("KC Compact (CPC clone)")) {
+                            this->boot(emu, system::kccompact);
                         }
                         ImGui::EndMenu();
                     }
                     if (ImGui::BeginMenu("Robotron Dresden")) {
-                        if (emu.check_roms(system::z9001, os_rom::z9001_os_1_2)) {
-                            if (ImGui::MenuItem("Z9001 (32KB)")) {
-                                emu.poweroff();
-                                emu.poweron(system::z9001, os_rom::z9001_os_1_2);
-                            }
+                        if (ImGui::MenuItem("Z9001 (32KB)")) {
+                            this->boot(emu, system::z9001, os_rom::z9001_os_1_2);
                         }
-                        if (emu.check_roms(system::kc87, os_rom::kc87_os_2)) {
-                            if (ImGui::MenuItem("KC87  (48KB)")) {
-                                emu.poweroff();
-                                emu.poweron(system::kc87, os_rom::kc87_os_2);
-                            }
+                        if (ImGui::MenuItem("KC87  (48KB)")) {
+                            this->boot(emu, system::kc87, os_rom::kc87_os_2);
                         }
                         ImGui::EndMenu();
                     }
                     if (ImGui::BeginMenu("Robotron Riesa")) {
-                        if (emu.check_roms(system::z1013_01)) {
-                            if (ImGui::MenuItem("Z1013.01 (1MHz, 16KB)")) {
-                                emu.poweroff();
-                                emu.poweron(system::z1013_01);
-                            }
+                        if (ImGui::MenuItem("Z1013.01 (1MHz, 16KB)")) {
+                            this->boot(emu, system::z1013_01);
                         }
-                        if (emu.check_roms(system::z1013_16)) {
-                            if (ImGui::MenuItem("Z1013.16 (2MHz, 16KB)")) {
-                                emu.poweroff();
-                                emu.poweron(system::z1013_16);
-                            }
+                        if (ImGui::MenuItem("Z1013.16 (2MHz, 16KB)")) {
+                            this->boot(emu, system::z1013_16);
                         }
-                        if (emu.check_roms(system::z1013_64)) {
-                            if (ImGui::MenuItem("Z1013.64 (2MHz, 64KB)")) {
-                                emu.poweroff();
-                                emu.poweron(system::z1013_64);
-                            }
+                        if (ImGui::MenuItem("Z1013.64 (2MHz, 64KB)")) {
+                            this->boot(emu, system::z1013_64);
                         }
                         ImGui::EndMenu();
                     }
                     if (ImGui::BeginMenu("Sinclair")) {
-                        if (emu.check_roms(system::zxspectrum48k)) {
-                            if (ImGui::MenuItem("ZX Spectrum 48K")) {
-                                emu.poweroff();
-                                emu.poweron(system::zxspectrum48k);
-                            }
+                        if (ImGui::MenuItem("ZX Spectrum 48K")) {
+                            this->boot(emu, system::zxspectrum48k);
                         }
-                        if (emu.check_roms(system::zxspectrum128k)) {
-                            if (ImGui::MenuItem("ZX Spectrum 128K")) {
-                                emu.poweroff();
-                                emu.poweron(system::zxspectrum128k);
-                            }
+                        if (ImGui::MenuItem("ZX Spectrum 128K")) {
+                            this->boot(emu, system::zxspectrum128k);
                         }
                         ImGui::EndMenu();
                     }
                     if (ImGui::BeginMenu("Amstrad")) {
-                        if (emu.check_roms(system::cpc464)) {
-                            if (ImGui::MenuItem("CPC 464")) {
-                                emu.poweroff();
-                                emu.poweron(system::cpc464);
-                            }
+                        if (ImGui::MenuItem("CPC 464")) {
+                            this->boot(emu, system::cpc464);
                         }
-                        if (emu.check_roms(system::cpc6128)) {
-                            if (ImGui::MenuItem("CPC 6128")) {
-                                emu.poweroff();
-                                emu.poweron(system::cpc6128);
-                            }
+                        if (ImGui::MenuItem("CPC 6128")) {
+                            this->boot(emu, system::cpc6128);
                         }
                         ImGui::EndMenu();
                     }
                     if (ImGui::BeginMenu("Acorn")) {
-                        if (emu.check_roms(system::acorn_atom)) {
-                            if (ImGui::MenuItem("Acorn Atom")) {
-                                emu.poweroff();
-                                emu.poweron(system::acorn_atom);
-                            }
+                        if (ImGui::MenuItem("Acorn Atom")) {
+                            this->boot(emu, system::acorn_atom);
                         }
                         ImGui::EndMenu();
                     }
                     if (ImGui::BeginMenu("Commodore")) {
-                        if (emu.check_roms(system::c64_pal)) {
-                            if (ImGui::MenuItem("C64 (PAL)")) {
-                                emu.poweroff();
-                                emu.poweron(system::c64_pal);
-                            }
+                        if (ImGui::MenuItem("C64 (PAL)")) {
+                            this->boot(emu, system::c64_pal);
                         }
                         ImGui::EndMenu();
                     }
@@ -318,11 +280,17 @@ UI::OnFrame(yakc& emu) {
                 ImGui::EndMenu();
             }
             if (ImGui::BeginMenu("Quickload")) {
-                for (const auto& item : this->FileLoader.Items) {
-                    if (int(item.Compat) & int(emu.model)) {
-                        if (ImGui::MenuItem(item.Name.AsCStr())) {
-                            this->FileLoader.LoadAuto(item);
-                        }
+                const int* indices = nullptr;
+                const int num = this->FileLoader.Catalog.query(emu.model, indices);
+                for (int i = 0; i < num; i++) {
+                    #if ORYOL_EMSCRIPTEN
+                    if (this->FileLoader.Catalog.at(indices[i]).native_only) {
+                        continue;
+                    }
+                    #endif
+                    const auto& item = this->FileLoader.Items[indices[i]];
+                    if (ImGui::MenuItem(item.Name.AsCStr())) {
+                        this->FileLoader.LoadAuto(item);
                     }
                 }
                 ImGui::EndMenu();
@@ -330,6 +298,8 @@ UI::OnFrame(yakc& emu) {
             if (ImGui::BeginMenu("Hardware")) {
                 if (emu.is_system(system::any_kc85)) {
                     if (ImGui::MenuItem("KC85 Expansion Slots")) {
+                        // module ROMs are only loaded when needed
+                        this->romLoader->LoadDeferred();
                         this->OpenWindow(emu, ModuleWindow::Create());
                     }
                     if (ImGui::MenuItem("KC85 Memory Map")) {
@@ -424,6 +394,20 @@ UI::OnFrame(yakc& emu) {
                 if (ImGui::MenuItem("Memory Editor")) {
                     this->OpenWindow(emu, MemoryWindow::Create());
                 }
+                if (ImGui::MenuItem("Memory Heatmap")) {
+                    this->OpenWindow(emu, MemoryHeatmapWindow::Create());
+                }
+                if (ImGui::MenuItem("Frame Timing")) {
+                    this->OpenWindow(emu, FrameTimeWindow::Create());
+                }
+                if (ImGui::MenuItem("Record Coverage", nullptr, emu.coverage.is_enabled())) {
+                    if (emu.coverage.is_enabled()) {
+                        emu.coverage.disable();
+                    }
+                    else {
+                        emu.coverage.enable();
+                    }
+                }
                 if (emu.is_system(system::any_kc85)) {
                     if (ImGui::MenuItem("Scan for Commands...")) {
                         this->OpenWindow(emu, CommandWindow::Create());
@@ -439,6 +423,30 @@ UI::OnFrame(yakc& emu) {
                     this->Settings.colorTV = !this->Settings.colorTV;
                 }
                 ImGui::SliderFloat("CRT Warp", &this->Settings.crtWarp, 0.0f, 1.0f/16.0f);
+                if (ImGui::MenuItem("Fast Tape Loading", nullptr, emu.fast_tape)) {
+                    emu.fast_tape = !emu.fast_tape;
+                }
+                if (ImGui::MenuItem("Warp While Disc Spins", nullptr, emu.fast_disc)) {
+                    emu.fast_disc = !emu.fast_disc;
+                }
+                if (ImGui::MenuItem("Fast Paste", nullptr, emu.fast_paste)) {
+                    emu.fast_paste = !emu.fast_paste;
+                }
+                if (ImGui::MenuItem("Boot Snapshot Cache", nullptr, emu.bootcache.enabled)) {
+                    emu.bootcache.enabled = !emu.bootcache.enabled;
+                }
+                if (ImGui::MenuItem("Skip Idle Frames", nullptr, emu.idle.is_enabled())) {
+                    if (emu.idle.is_enabled()) {
+                        emu.idle.disable();
+                    }
+                    else {
+                        emu.idle.enable();
+                    }
+                }
+                const bool autoWarp = emu.is_auto_warp_enabled(emu.model);
+                if (ImGui::MenuItem("Auto-Warp Tape Loading", nullptr, autoWarp)) {
+                    emu.enable_auto_warp(emu.model, !autoWarp);
+                }
                 ImGui::SliderInt("CPU Speed", &emu.accel, 1, 8, "%.0fx");
                 if (ImGui::MenuItem("Reset To Defaults")) {
                     this->Settings = settings();
@@ -449,6 +457,14 @@ UI::OnFrame(yakc& emu) {
             ImGui::Text("joy: %s", emu.is_joystick_enabled()?"ON ":"OFF");
             ImGui::SameLine();
             ImGui::Text("emu: %.2fms", this->EmulationTime.AsMilliSeconds());
+            if (emu.warp_saved_us > 0) {
+                ImGui::SameLine();
+                ImGui::Text("warp saved: %.1fs", emu.warp_saved_us / 1000000.0);
+            }
+            if (emu.idle.can_skip()) {
+                ImGui::SameLine();
+                ImGui::Text("idle");
+            }
             ImGui::EndMainMenuBar();
         }
 
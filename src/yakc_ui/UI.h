@@ -7,6 +7,7 @@
 #include "yakc_oryol/Audio.h"
 #include "yakc_ui/WindowBase.h"
 #include "yakc_oryol/FileLoader.h"
+#include "yakc_oryol/RomLoader.h"
 #include "Core/Time/TimePoint.h"
 #include "Core/Containers/Array.h"
 #include "IMUI/IMUI.h"
@@ -18,7 +19,7 @@ class Audio;
 class UI {
 public:
     /// setup the UI
-    void Setup(yakc& emu, Audio* audio);
+    void Setup(yakc& emu, Audio* audio, RomLoader* romLoader, ArchiveLoader* archive=nullptr);
     /// discard the UI
     void Discard();
     /// do one frame
@@ -33,6 +34,8 @@ public:
     void EnableDarkTheme();
     /// switch to light UI theme
     void EnableLightTheme();
+    /// load required ROMs, and switch to another system
+    void boot(yakc& emu, system m, os_rom os=os_rom::none);
 
     static ImVec4 DefaultTextColor;
     static ImVec4 EnabledColor;
@@ -60,6 +63,7 @@ public:
     Oryol::Ptr<WindowBase> loadWindow;
     bool uiEnabled = false;
     Audio* audio;
+    RomLoader* romLoader = nullptr;
 };
 
 } // namespace YAKC
@@ -3,6 +3,7 @@
 //------------------------------------------------------------------------------
 #include "Util.h"
 #include "IMUI/IMUI.h"
+#include "yakc/yakc.h"
 #include <stdio.h>
 
 namespace YAKC {
@@ -95,4 +96,52 @@ Util::RGBA8toImVec4(uint32_t c) {
     return v;
 }
 
+//------------------------------------------------------------------------------
+void
+Util::DrawIOStats(yakc& emu, chip::id c, int numRegs, const char* const* regNames) {
+    if (ImGui::CollapsingHeader("I/O Accesses", "#iostats", true, false)) {
+        iostats& stats = emu.iostats;
+        bool enabled = stats.is_enabled();
+        if (ImGui::Checkbox("On", &enabled)) {
+            if (enabled) {
+                stats.enable();
+            }
+            else {
+                stats.disable();
+            }
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Clear")) {
+            stats.clear();
+        }
+        ImGui::SameLine();
+        ImGui::Text("%.1fs", stats.seconds());
+        const uint32_t reads = stats.count(c, iostats::read);
+        const uint32_t writes = stats.count(c, iostats::write);
+        ImGui::Text("reads: %d (%.0f/s)", reads, stats.rate(reads));
+        ImGui::Text("writes: %d (%.0f/s)", writes, stats.rate(writes));
+        ImGui::Columns(3, "##ioregs", false);
+        ImGui::Text("Reg"); ImGui::NextColumn();
+        ImGui::Text("Reads/s"); ImGui::NextColumn();
+        ImGui::Text("Writes/s"); ImGui::NextColumn();
+        ImGui::Separator();
+        for (int reg = 0; reg < numRegs; reg++) {
+            const uint32_t r = stats.reg_count(c, reg, iostats::read);
+            const uint32_t w = stats.reg_count(c, reg, iostats::write);
+            if (r || w) {
+                if (regNames) {
+                    ImGui::Text("%s", regNames[reg]);
+                }
+                else {
+                    ImGui::Text("%02X", reg);
+                }
+                ImGui::NextColumn();
+                ImGui::Text("%.0f", stats.rate(r)); ImGui::NextColumn();
+                ImGui::Text("%.0f", stats.rate(w)); ImGui::NextColumn();
+            }
+        }
+        ImGui::Columns(1);
+    }
+}
+
 } // namespace YAKC
@@ -9,6 +9,8 @@
 
 namespace YAKC {
 
+class yakc;
+
 class Util {
 public:
     /// draw an 8-bit hex input widget
@@ -27,6 +29,8 @@ public:
     static uint8_t ParseUByte(const char* str, uint8_t oldVal);
     /// convert a RGBA8 uint32_t to an ImVec4
     static ImVec4 RGBA8toImVec4(uint32_t c);
+    /// draw the I/O access counters of a chip (register names are optional)
+    static void DrawIOStats(yakc& emu, chip::id c, int numRegs, const char* const* regNames=nullptr);
 };
 
 } // namespace YAKC
@@ -15,6 +15,8 @@
 #include "yakc_oryol/Draw.h"
 #include "yakc_oryol/Audio.h"
 #include "yakc_oryol/Keyboard.h"
+#include "yakc_oryol/RomLoader.h"
+#include "yakc_oryol/ArchiveLoader.h"
 #if YAKC_UI
 #include "yakc_ui/UI.h"
 #endif
@@ -45,6 +47,10 @@ public:
     UI ui;
     #endif
     TimePoint lapTimePoint;
+    ArchiveLoader archiveLoader;
+    RomLoader romLoader;
+    /// optional local directory to load files from, instead of HTTP
+    String localDir;
 };
 OryolMain(YakcApp);
 
@@ -63,6 +69,10 @@ YakcApp::OnInit() {
     #else
     String baseUrl = "http://floooh.github.com/virtualkc/";
     #endif
+    // '-local [dir]' maps ROMs and program files directly from a local directory
+    if (OryolArgs.HasArg("-local")) {
+        this->localDir = OryolArgs.GetString("-local");
+    }
     IOSetup ioSetup;
     ioSetup.FileSystems.Add("http", HTTPFileSystem::Creator());
     ioSetup.Assigns.Add("kcc:", baseUrl);
@@ -96,14 +106,19 @@ YakcApp::OnInit() {
     sys_funcs.free_func = [] (void* p) { Oryol::Memory::Free(p); };
     this->emu.init(sys_funcs);
 
-    // initialize the ROM dumps and modules
+    // initialize the ROM dumps and modules, ROMs and programs are
+    // extracted from the packed archive when available
+    this->archiveLoader.Setup(this->localDir);
+    this->romLoader.Setup(this->emu, this->localDir, &this->archiveLoader);
     this->initRoms();
 
     // switch the emulator on
     this->emu.poweron(YAKC::system::kc85_3, os_rom::caos_3_1);
 
     #if YAKC_UI
-    this->ui.Setup(this->emu, &this->audio);
+    // NOTE: LocalDir must be set before Setup, which loads the software catalog
+    this->ui.FileLoader.LocalDir = this->localDir;
+    this->ui.Setup(this->emu, &this->audio, &this->romLoader, &this->archiveLoader);
     #endif
 
     // on KC85/3 put a 16kByte module into slot 8 by default, CAOS will initialize
@@ -184,6 +199,8 @@ YakcApp::OnRunning() {
 AppState::Code
 YakcApp::OnCleanup() {
     this->keyboard.Discard();
+    this->romLoader.Discard();
+    this->archiveLoader.Discard();
     this->audio.Discard();
     this->draw.Discard();
     #if YAKC_UI
@@ -200,103 +217,11 @@ void
 YakcApp::initRoms() {
 
     // only KC85/3 roms are 'built-in' to reeduce executable size
-    this->emu.add_rom(rom_images::caos31, dump_caos31, sizeof(dump_caos31));
-    this->emu.add_rom(rom_images::kc85_basic_rom, dump_basic_c0, sizeof(dump_basic_c0));
+    this->emu.add_rom_ref(rom_images::caos31, dump_caos31, sizeof(dump_caos31));
+    this->emu.add_rom_ref(rom_images::kc85_basic_rom, dump_basic_c0, sizeof(dump_basic_c0));
 
-    // async-load optional ROMs
-    IO::Load("rom:hc900.852", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::hc900, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:caos22.852", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::caos22, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:caos34.853", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::caos34, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:caos42c.854", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::caos42c, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:caos42e.854", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::caos42e, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:z1013_mon202.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::z1013_mon202, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:z1013_mon_a2.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::z1013_mon_a2, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:z1013_font.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::z1013_font, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:z9001_os12_1.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::z9001_os12_1, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:z9001_os12_2.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::z9001_os12_2, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:z9001_font.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::z9001_font, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:z9001_basic.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::z9001_basic, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:kc87_os_2.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::kc87_os_2, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:z9001_basic_507_511.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::z9001_basic_507_511, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:kc87_font_2.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::kc87_font_2, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:amstrad_zx48k.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::zx48k, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:amstrad_zx128k_0.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::zx128k_0, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:amstrad_zx128k_1.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::zx128k_1, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:cpc464_os.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::cpc464_os, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:cpc464_basic.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::cpc464_basic, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:cpc6128_os.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::cpc6128_os, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:cpc6128_basic.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::cpc6128_basic, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:cpc6128_amsdos.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::cpc6128_amsdos, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:kcc_os.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::kcc_os, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:kcc_bas.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::kcc_basic, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:abasic.ic20", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::atom_basic, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:afloat.ic21", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::atom_float, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:dosrom.u15", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::atom_dos, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:c64_kernalv3.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::c64_kernalv3, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:c64_char.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::c64_char, ioRes.Data.Data(), ioRes.Data.Size());
-    });
-    IO::Load("rom:c64_basic.bin", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::c64_basic, ioRes.Data.Data(), ioRes.Data.Size());
-    });
+    // all other ROMs are loaded on demand through the RomLoader
+    // when switching to a different system
 }
 
 //------------------------------------------------------------------------------
@@ -322,8 +247,7 @@ YakcApp::initModules() {
         "...where [SLOT] is 08 or 0C.\n");
 
     // M026 FORTH
-    IO::Load("rom:forth.853", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::forth, ioRes.Data.Data(), ioRes.Data.Size());
+    this->romLoader.Defer(rom_images::forth, []() {
         kc85.register_rom_module(KC85_MODULE_M026_FORTH,
             roms.ptr(rom_images::forth), roms.size(rom_images::forth),
             "FORTH language expansion module.\n\n"
@@ -335,8 +259,7 @@ YakcApp::initModules() {
     });
 
     // M027 DEVELOPMENT
-    IO::Load("rom:develop.853", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::develop, ioRes.Data.Data(), ioRes.Data.Size());
+    this->romLoader.Defer(rom_images::develop, []() {
         kc85.register_rom_module(KC85_MODULE_M027_DEVELOPMENT,
             roms.ptr(rom_images::develop), roms.size(rom_images::develop),
             "Assembler/disassembler expansion module.\n\n"
@@ -348,8 +271,7 @@ YakcApp::initModules() {
     });
 
     // M006 BASIC (+ HC-CAOS 901)
-    IO::Load("rom:m006.rom", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::kc85_basic_mod, ioRes.Data.Data(), ioRes.Data.Size());
+    this->romLoader.Defer(rom_images::kc85_basic_mod, []() {
         kc85.register_rom_module(KC85_MODULE_M006_BASIC,
             roms.ptr(rom_images::kc85_basic_mod), roms.size(rom_images::kc85_basic_mod),
             "BASIC + HC-901 CAOS for KC85/2.\n\n"
@@ -359,8 +281,7 @@ YakcApp::initModules() {
     });
 
     // M012 TEXOR
-    IO::Load("rom:texor.rom", [this](IO::LoadResult ioRes) {
-        this->emu.add_rom(rom_images::texor, ioRes.Data.Data(), ioRes.Data.Size());
+    this->romLoader.Defer(rom_images::texor, []() {
         kc85.register_rom_module(KC85_MODULE_M012_TEXOR,
             roms.ptr(rom_images::texor), roms.size(rom_images::texor),
             "TEXOR text processing software.\n\n"
@@ -384,8 +305,10 @@ EMSCRIPTEN_KEEPALIVE void yakc_boot(const char* sys_str, const char* os_str) {
         auto sys = system_from_string(sys_str);
         os_rom os = os_from_string(os_str);
         if (system::none != sys) {
-            app->emu.poweroff();
-            app->emu.poweron(sys, os);
+            app->romLoader.Prepare(sys, os, [app, sys, os]() {
+                app->emu.poweroff();
+                app->emu.poweron(sys, os);
+            });
         }
     }
 }